@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "tgaImage/PixelFormat.hpp"
+#include "tgaImage/TGAImage.hpp"
+#include "tgaImage/TGAImageLoad.hpp"
+
+namespace imageloader::benchmarks
+{
+    // Uncompressed image of random pixels, the same seed always yields the same image
+    inline TGAImage randomImage(const int& width, const int& height, const int& bytesPerPixel, const unsigned int& seed = 1)
+    {
+        std::mt19937 generator{seed};
+        std::uniform_int_distribution<int> distribution{0, 255};
+
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width)*height*bytesPerPixel);
+        for(auto& value : pixels)
+        {
+            value = static_cast<std::uint8_t>(distribution(generator));
+        }
+
+        TGAHeader header{};
+        header.imagetypecode = bytesPerPixel == 1 ? 3 : 2;
+        header.width = static_cast<std::uint16_t>(width);
+        header.height = static_cast<std::uint16_t>(height);
+        header.bitsperpixel = static_cast<std::uint8_t>(bytesPerPixel*8);
+
+        return TGAImage{width, height, bytesPerPixel, header, std::move(pixels)};
+    }
+
+    inline std::int64_t imageBytes(const TGAImage& image)
+    {
+        return static_cast<std::int64_t>(image.width())*image.height()*image.bitsPerPixel();
+    }
+
+    inline std::int64_t imagePixels(const TGAImage& image)
+    {
+        return static_cast<std::int64_t>(image.width())*image.height();
+    }
+
+    // Content of the synthetic corpus, from worst to best case for RLE
+    enum class corpusKind
+    {
+        // Random bytes, no runs at all
+        NOISE,
+        // Smooth ramps, runs of a few pixels at most
+        GRADIENT,
+        // Flat shapes with outlines and banded shading on a transparent background, like game sprites and UI art
+        SPRITE,
+        // A single color, one run per 128 pixels
+        FLAT
+    };
+
+    // Formats of the corpus by bytes per pixel, 16 bit images carry a one bit alpha channel
+    inline pixelFormat corpusFormat(const int& bytesPerPixel)
+    {
+        switch(bytesPerPixel)
+        {
+            case 1:
+                return pixelFormat::GRAY;
+            case 2:
+                return pixelFormat::BGRA5551;
+            case 3:
+                return pixelFormat::BGR;
+            default:
+                return pixelFormat::BGRA;
+        }
+    }
+
+    // Deterministic corpus image, content is generated as BGRA and converted to the format of bytesPerPixel
+    inline TGAImage corpusImage(const corpusKind& kind, const int& width, const int& height, const int& bytesPerPixel,
+                                const unsigned int& seed = 1)
+    {
+        if(corpusKind::NOISE == kind)
+        {
+            return randomImage(width, height, bytesPerPixel, seed);
+        }
+
+        const auto pixelCount = static_cast<std::size_t>(width)*height;
+        std::vector<std::uint8_t> bgra(pixelCount*4, 0);
+        auto pixel = [&](const int& x, const int& y) { return bgra.data() + (static_cast<std::size_t>(y)*width + x)*4; };
+
+        if(corpusKind::FLAT == kind)
+        {
+            constexpr std::array<std::uint8_t, 4> color{64, 128, 192, 255};
+            for(std::size_t index = 0; index < pixelCount; ++index)
+            {
+                std::copy(color.begin(), color.end(), bgra.data() + index*4);
+            }
+        }
+        else if(corpusKind::GRADIENT == kind)
+        {
+            for(auto y = 0; y < height; ++y)
+            {
+                for(auto x = 0; x < width; ++x)
+                {
+                    const auto output = pixel(x, y);
+                    output[0] = static_cast<std::uint8_t>(x*255/std::max(width - 1, 1));
+                    output[1] = static_cast<std::uint8_t>(y*255/std::max(height - 1, 1));
+                    output[2] = static_cast<std::uint8_t>((x + y)*255/std::max(width + height - 2, 1));
+                    output[3] = 255;
+                }
+            }
+        }
+        else
+        {
+            // Ellipses of one color each, shaded in bands of four rows and outlined with a darker shade
+            std::mt19937 generator{seed};
+            const auto shapeCount = std::max(4, width*height/(64*64));
+            for(auto shape = 0; shape < shapeCount; ++shape)
+            {
+                const auto radiusX = std::max(2, static_cast<int>(generator()%std::max(width/8, 3)));
+                const auto radiusY = std::max(2, static_cast<int>(generator()%std::max(height/8, 3)));
+                const auto centerX = static_cast<int>(generator()%width);
+                const auto centerY = static_cast<int>(generator()%height);
+                const auto color = generator();
+
+                for(auto y = std::max(centerY - radiusY, 0); y <= std::min(centerY + radiusY, height - 1); ++y)
+                {
+                    for(auto x = std::max(centerX - radiusX, 0); x <= std::min(centerX + radiusX, width - 1); ++x)
+                    {
+                        const auto dx = static_cast<double>(x - centerX)/radiusX;
+                        const auto dy = static_cast<double>(y - centerY)/radiusY;
+                        const auto distance = dx*dx + dy*dy;
+                        if(distance > 1.0)
+                        {
+                            continue;
+                        }
+
+                        const auto shade = distance > 0.8 ? 64 : 255 - ((y - centerY + radiusY)/4)*4%96;
+                        const auto output = pixel(x, y);
+                        for(auto channel = 0; channel < 3; ++channel)
+                        {
+                            output[channel] = static_cast<std::uint8_t>(((color >> (channel*8)) & 0xFF)*shade/255);
+                        }
+                        output[3] = 255;
+                    }
+                }
+            }
+        }
+
+        const auto format = corpusFormat(bytesPerPixel);
+        std::vector<std::uint8_t> pixels(pixelCount*bytesPerPixel);
+        convertPixels(bgra.data(), pixelFormat::BGRA, pixels.data(), format, pixelCount);
+
+        TGAHeader header{};
+        header.imagetypecode = bytesPerPixel == 1 ? 3 : 2;
+        header.width = static_cast<std::uint16_t>(width);
+        header.height = static_cast<std::uint16_t>(height);
+        header.bitsperpixel = static_cast<std::uint8_t>(bytesPerPixel*8);
+        header.imagedescriptor = static_cast<std::uint8_t>(bytesPerPixel == 2 ? 1 : bytesPerPixel == 4 ? 8 : 0);
+
+        return TGAImage{width, height, bytesPerPixel, header, std::move(pixels)};
+    }
+
+    // Stored corpus image in the temporary directory, written once per process so every run measures fresh files
+    inline std::string corpusFile(const corpusKind& kind, const int& width, const int& height, const int& bytesPerPixel,
+                                  const bool& compressed)
+    {
+        static const char* kindNames[] = {"noise", "gradient", "sprite", "flat"};
+        static std::set<std::string> written;
+
+        const auto directory = std::filesystem::temp_directory_path()/"imageloader-benchmarks";
+        const auto path = (directory/(std::string{kindNames[static_cast<int>(kind)]} + "-" + std::to_string(width) + "x" +
+                                      std::to_string(height) + "-" + std::to_string(bytesPerPixel*8) +
+                                      (compressed ? "-rle.tga" : ".tga"))).string();
+
+        if(written.insert(path).second)
+        {
+            TGAImageLoader loader;
+            loader.storeImage(path, corpusImage(kind, width, height, bytesPerPixel),
+                              compressed ? compressionStatus::YES : compressionStatus::NO);
+        }
+
+        return path;
+    }
+} // namespace imageloader::benchmarks
@@ -0,0 +1,17 @@
+#include <benchmark/benchmark.h>
+
+// Results of different versions are compared with benchmark's compare.py, the version in the context tells them apart
+int main(int argc, char** argv)
+{
+    ::benchmark::Initialize(&argc, argv);
+    if(::benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    ::benchmark::AddCustomContext("imageloader_version", IMAGELOADER_VERSION);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+
+    return 0;
+}
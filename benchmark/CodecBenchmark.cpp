@@ -0,0 +1,424 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "BenchmarkImages.hpp"
+#include "PixelSize.hpp"
+#include "RunLength.hpp"
+#include "tgaImage/TGAImageLoad.hpp"
+
+namespace
+{
+    using imageloader::benchmarks::corpusFile;
+    using imageloader::benchmarks::corpusImage;
+    using imageloader::benchmarks::corpusKind;
+    using imageloader::benchmarks::imageBytes;
+    using imageloader::benchmarks::imagePixels;
+
+    // 16K wide images are strips, so the whole corpus stays within the memory of a build machine
+    int corpusHeight(const int& width)
+    {
+        return width > 4096 ? 1024 : width;
+    }
+
+    // Arguments: image width in pixels, bytes per pixel, RLE compressed
+    void corpusArguments(::benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"width", "bpp", "rle"});
+        for(const auto width : {64, 512, 4096, 16384})
+        {
+            for(const auto bytesPerPixel : {1, 2, 3, 4})
+            {
+                for(const auto compressed : {0, 1})
+                {
+                    benchmark->Args({width, bytesPerPixel, compressed});
+                }
+            }
+        }
+    }
+
+    // Arguments: image width in pixels, bytes per pixel
+    void pixelArguments(::benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"width", "bpp"});
+        for(const auto width : {64, 512, 4096})
+        {
+            for(const auto bytesPerPixel : {1, 2, 3, 4})
+            {
+                benchmark->Args({width, bytesPerPixel});
+            }
+        }
+    }
+
+    // Throughput is counted in decoded pixel bytes for raw and RLE images alike, so the two are comparable
+    void setProcessed(::benchmark::State& state, const imageloader::TGAImage& image)
+    {
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+        state.SetItemsProcessed(state.iterations()*imagePixels(image));
+    }
+
+    void BM_LoadImage(::benchmark::State& state, const corpusKind& kind)
+    {
+        const auto width = static_cast<int>(state.range(0));
+        const auto bytesPerPixel = static_cast<int>(state.range(1));
+        const auto path = corpusFile(kind, width, corpusHeight(width), bytesPerPixel, state.range(2) != 0);
+        imageloader::TGAImageLoader loader;
+
+        std::unique_ptr<imageloader::TGAImage> image;
+        for(auto _ : state)
+        {
+            auto result = loader.loadImage(path);
+            if(std::holds_alternative<imageloader::ErrorCodes>(result))
+            {
+                state.SkipWithError("corpus image could not be loaded");
+                return;
+            }
+            image.reset(std::get<imageloader::TGAImage*>(result));
+        }
+
+        setProcessed(state, *image);
+        state.counters["file_bytes"] = static_cast<double>(std::filesystem::file_size(path));
+    }
+    BENCHMARK_CAPTURE(BM_LoadImage, noise, corpusKind::NOISE)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_LoadImage, gradient, corpusKind::GRADIENT)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_LoadImage, sprite, corpusKind::SPRITE)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_LoadImage, flat, corpusKind::FLAT)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+
+    void BM_StoreImage(::benchmark::State& state, const corpusKind& kind)
+    {
+        const auto width = static_cast<int>(state.range(0));
+        const auto image = corpusImage(kind, width, corpusHeight(width), static_cast<int>(state.range(1)));
+        const auto status = state.range(2) != 0 ? imageloader::compressionStatus::YES : imageloader::compressionStatus::NO;
+        const auto path = (std::filesystem::temp_directory_path()/"imageloader-benchmarks"/"store.tga").string();
+        imageloader::TGAImageLoader loader;
+
+        for(auto _ : state)
+        {
+            auto result = loader.storeImage(path, image, status);
+            ::benchmark::DoNotOptimize(result);
+        }
+
+        setProcessed(state, image);
+        std::filesystem::remove(path);
+    }
+    BENCHMARK_CAPTURE(BM_StoreImage, noise, corpusKind::NOISE)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_StoreImage, gradient, corpusKind::GRADIENT)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_StoreImage, sprite, corpusKind::SPRITE)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_StoreImage, flat, corpusKind::FLAT)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+
+    // In-memory decode, no filesystem involved: a copy for raw images, decompressRunLength for RLE images
+    void BM_Decode(::benchmark::State& state, const corpusKind& kind)
+    {
+        const auto width = static_cast<int>(state.range(0));
+        const auto image = corpusImage(kind, width, corpusHeight(width), static_cast<int>(state.range(1)));
+        imageloader::TGAImageLoader loader;
+        std::vector<std::uint8_t> encoded;
+        loader.encode(image, encoded, state.range(2) != 0 ? imageloader::compressionStatus::YES : imageloader::compressionStatus::NO);
+
+        for(auto _ : state)
+        {
+            auto result = loader.decode(encoded.data(), encoded.size());
+            if(std::holds_alternative<imageloader::ErrorCodes>(result))
+            {
+                state.SkipWithError("corpus image could not be decoded");
+                return;
+            }
+            delete std::get<imageloader::TGAImage*>(result);
+        }
+
+        setProcessed(state, image);
+        state.counters["encoded_bytes"] = static_cast<double>(encoded.size());
+    }
+    BENCHMARK_CAPTURE(BM_Decode, noise, corpusKind::NOISE)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_Decode, gradient, corpusKind::GRADIENT)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_Decode, sprite, corpusKind::SPRITE)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_Decode, flat, corpusKind::FLAT)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+
+    // In-memory encode into a reused buffer: a copy for raw images, compressRunLength for RLE images
+    void BM_Encode(::benchmark::State& state, const corpusKind& kind)
+    {
+        const auto width = static_cast<int>(state.range(0));
+        const auto image = corpusImage(kind, width, corpusHeight(width), static_cast<int>(state.range(1)));
+        const auto status = state.range(2) != 0 ? imageloader::compressionStatus::YES : imageloader::compressionStatus::NO;
+        imageloader::TGAImageLoader loader;
+        std::vector<std::uint8_t> encoded;
+
+        for(auto _ : state)
+        {
+            encoded.clear();
+            loader.encode(image, encoded, status);
+            ::benchmark::DoNotOptimize(encoded.data());
+        }
+
+        setProcessed(state, image);
+        state.counters["encoded_bytes"] = static_cast<double>(encoded.size());
+    }
+    BENCHMARK_CAPTURE(BM_Encode, noise, corpusKind::NOISE)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_Encode, gradient, corpusKind::GRADIENT)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_Encode, sprite, corpusKind::SPRITE)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_Encode, flat, corpusKind::FLAT)->Apply(corpusArguments)->Unit(::benchmark::kMicrosecond);
+
+    using DecodeKernel = std::optional<imageloader::ErrorCodes> (imageloader::RunLengthDecoder::*)(const std::uint8_t*&, const std::uint8_t*,
+                                                                                                  std::uint8_t*&, std::uint8_t*);
+    using EncodeKernel = std::size_t (imageloader::RunLengthEncoder::*)(const std::uint8_t*, const std::size_t&, std::size_t,
+                                                                        std::vector<std::uint8_t>&, const std::size_t&);
+
+    // Arguments: bytes per pixel, kernel compiled for that pixel size (1) or the generic kernel taking any size (0)
+    void kernelArguments(::benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"bpp", "fixed"});
+        for(const auto bytesPerPixel : {1, 2, 3, 4})
+        {
+            for(const auto fixed : {0, 1})
+            {
+                benchmark->Args({bytesPerPixel, fixed});
+            }
+        }
+    }
+
+    void BM_RunLengthDecode(::benchmark::State& state, const corpusKind& kind)
+    {
+        const auto bytesPerPixel = static_cast<int>(state.range(0));
+        const auto image = corpusImage(kind, 512, 512, bytesPerPixel);
+        const auto pixelCount = static_cast<std::size_t>(imagePixels(image));
+        const auto kernel = imageloader::withPixelSize(state.range(1) != 0 ? bytesPerPixel : 0, [](auto size) -> DecodeKernel
+        {
+            return &imageloader::RunLengthDecoder::decodePixels<decltype(size)::value>;
+        });
+
+        std::vector<std::uint8_t> encoded;
+        imageloader::RunLengthEncoder{bytesPerPixel}.encode(image.constData(), pixelCount, 0, encoded, std::numeric_limits<std::size_t>::max());
+        std::vector<std::uint8_t> decoded(imageBytes(image));
+
+        for(auto _ : state)
+        {
+            imageloader::RunLengthDecoder decoder{bytesPerPixel, pixelCount};
+            const std::uint8_t* input = encoded.data();
+            auto output = decoded.data();
+            auto result = (decoder.*kernel)(input, encoded.data() + encoded.size(), output, decoded.data() + decoded.size());
+            ::benchmark::DoNotOptimize(result);
+            ::benchmark::DoNotOptimize(decoded.data());
+        }
+
+        setProcessed(state, image);
+    }
+    BENCHMARK_CAPTURE(BM_RunLengthDecode, noise, corpusKind::NOISE)->Apply(kernelArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_RunLengthDecode, gradient, corpusKind::GRADIENT)->Apply(kernelArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_RunLengthDecode, sprite, corpusKind::SPRITE)->Apply(kernelArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_RunLengthDecode, flat, corpusKind::FLAT)->Apply(kernelArguments)->Unit(::benchmark::kMicrosecond);
+
+    void BM_RunLengthEncode(::benchmark::State& state, const corpusKind& kind)
+    {
+        const auto bytesPerPixel = static_cast<int>(state.range(0));
+        const auto image = corpusImage(kind, 512, 512, bytesPerPixel);
+        const auto pixelCount = static_cast<std::size_t>(imagePixels(image));
+        const auto kernel = imageloader::withPixelSize(state.range(1) != 0 ? bytesPerPixel : 0, [](auto size) -> EncodeKernel
+        {
+            return &imageloader::RunLengthEncoder::encodePixels<decltype(size)::value>;
+        });
+
+        std::vector<std::uint8_t> encoded;
+        encoded.reserve(2*imageBytes(image));
+
+        for(auto _ : state)
+        {
+            imageloader::RunLengthEncoder encoder{bytesPerPixel};
+            encoded.clear();
+            (encoder.*kernel)(image.constData(), pixelCount, 0, encoded, std::numeric_limits<std::size_t>::max());
+            ::benchmark::DoNotOptimize(encoded.data());
+        }
+
+        setProcessed(state, image);
+        state.counters["encoded_bytes"] = static_cast<double>(encoded.size());
+    }
+    BENCHMARK_CAPTURE(BM_RunLengthEncode, noise, corpusKind::NOISE)->Apply(kernelArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_RunLengthEncode, gradient, corpusKind::GRADIENT)->Apply(kernelArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_RunLengthEncode, sprite, corpusKind::SPRITE)->Apply(kernelArguments)->Unit(::benchmark::kMicrosecond);
+    BENCHMARK_CAPTURE(BM_RunLengthEncode, flat, corpusKind::FLAT)->Apply(kernelArguments)->Unit(::benchmark::kMicrosecond);
+
+    void BM_ProbeImage(::benchmark::State& state)
+    {
+        const auto path = corpusFile(corpusKind::SPRITE, 512, 512, 4, true);
+        imageloader::TGAImageLoader loader;
+
+        for(auto _ : state)
+        {
+            auto result = loader.probeImage(path);
+            ::benchmark::DoNotOptimize(result);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_ProbeImage);
+
+    // Every kind and pixel size at 512x512, raw and RLE
+    std::vector<std::string> batchFiles()
+    {
+        std::vector<std::string> paths;
+        for(const auto kind : {corpusKind::NOISE, corpusKind::GRADIENT, corpusKind::SPRITE, corpusKind::FLAT})
+        {
+            for(const auto bytesPerPixel : {1, 2, 3, 4})
+            {
+                for(const auto compressed : {false, true})
+                {
+                    paths.push_back(corpusFile(kind, 512, 512, bytesPerPixel, compressed));
+                }
+            }
+        }
+
+        return paths;
+    }
+
+    // Arguments: ioBackend, queue depth
+    void batchArguments(::benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"backend", "depth"});
+        benchmark->Args({static_cast<int>(imageloader::ioBackend::BLOCKING), 0});
+        for(const auto backend : {imageloader::ioBackend::THREAD_POOL, imageloader::ioBackend::IO_URING})
+        {
+            for(const auto depth : {4, 64})
+            {
+                benchmark->Args({static_cast<int>(backend), depth});
+            }
+        }
+    }
+
+    void BM_LoadImages(::benchmark::State& state)
+    {
+        const auto paths = batchFiles();
+        imageloader::TGAImageLoader loader;
+        const auto backend = static_cast<imageloader::ioBackend>(state.range(0));
+        if(loader.setIOBackend(backend, static_cast<unsigned int>(state.range(1))) != backend)
+        {
+            state.SkipWithError("I/O backend is not available");
+            return;
+        }
+
+        std::int64_t batchBytes = 0;
+        for(auto _ : state)
+        {
+            batchBytes = 0;
+            for(auto& result : loader.loadImages(paths))
+            {
+                if(std::holds_alternative<imageloader::ErrorCodes>(result))
+                {
+                    state.SkipWithError("corpus image could not be loaded");
+                    return;
+                }
+
+                std::unique_ptr<imageloader::TGAImage> image{std::get<imageloader::TGAImage*>(result)};
+                batchBytes += imageBytes(*image);
+            }
+        }
+
+        state.SetBytesProcessed(state.iterations()*batchBytes);
+        state.SetItemsProcessed(state.iterations()*static_cast<std::int64_t>(paths.size()));
+    }
+    BENCHMARK(BM_LoadImages)->Apply(batchArguments)->Unit(::benchmark::kMillisecond)->UseRealTime();
+
+    void BM_StoreImages(::benchmark::State& state)
+    {
+        std::vector<imageloader::TGAImage> images;
+        std::vector<std::string> paths;
+        const auto directory = std::filesystem::temp_directory_path()/"imageloader-benchmarks"/"batch";
+        for(const auto kind : {corpusKind::NOISE, corpusKind::GRADIENT, corpusKind::SPRITE, corpusKind::FLAT})
+        {
+            for(const auto bytesPerPixel : {1, 2, 3, 4})
+            {
+                images.push_back(corpusImage(kind, 512, 512, bytesPerPixel));
+                paths.push_back((directory/("store-" + std::to_string(paths.size()) + ".tga")).string());
+            }
+        }
+
+        std::vector<const imageloader::TGAImage*> imagePointers;
+        std::int64_t batchBytes = 0;
+        for(const auto& image : images)
+        {
+            imagePointers.push_back(&image);
+            batchBytes += imageBytes(image);
+        }
+
+        imageloader::TGAImageLoader loader;
+        const auto backend = static_cast<imageloader::ioBackend>(state.range(0));
+        if(loader.setIOBackend(backend, static_cast<unsigned int>(state.range(1))) != backend)
+        {
+            state.SkipWithError("I/O backend is not available");
+            return;
+        }
+
+        for(auto _ : state)
+        {
+            auto results = loader.storeImages(paths, imagePointers, imageloader::compressionStatus::YES);
+            ::benchmark::DoNotOptimize(results);
+        }
+
+        state.SetBytesProcessed(state.iterations()*batchBytes);
+        state.SetItemsProcessed(state.iterations()*static_cast<std::int64_t>(paths.size()));
+        std::filesystem::remove_all(directory);
+    }
+    BENCHMARK(BM_StoreImages)->Apply(batchArguments)->Unit(::benchmark::kMillisecond)->UseRealTime();
+
+    void BM_Color(::benchmark::State& state)
+    {
+        const auto width = static_cast<int>(state.range(0));
+        const auto image = corpusImage(corpusKind::NOISE, width, width, static_cast<int>(state.range(1)));
+
+        for(auto _ : state)
+        {
+            std::uint32_t sum = 0;
+            for(auto y = 0; y < image.height(); ++y)
+            {
+                for(auto x = 0; x < image.width(); ++x)
+                {
+                    sum += std::get<imageloader::TGAColor>(image.color(x, y)).bgra[0];
+                }
+            }
+            ::benchmark::DoNotOptimize(sum);
+        }
+
+        setProcessed(state, image);
+    }
+    BENCHMARK(BM_Color)->Apply(pixelArguments)->Unit(::benchmark::kMicrosecond);
+
+    void BM_SetColor(::benchmark::State& state)
+    {
+        const auto width = static_cast<int>(state.range(0));
+        auto image = corpusImage(corpusKind::NOISE, width, width, static_cast<int>(state.range(1)));
+        const imageloader::TGAColor color{16, 32, 64, 255};
+
+        for(auto _ : state)
+        {
+            for(auto y = 0; y < image.height(); ++y)
+            {
+                for(auto x = 0; x < image.width(); ++x)
+                {
+                    image.setColor(x, y, color);
+                }
+            }
+            ::benchmark::DoNotOptimize(image.constData());
+        }
+
+        setProcessed(state, image);
+    }
+    BENCHMARK(BM_SetColor)->Apply(pixelArguments)->Unit(::benchmark::kMicrosecond);
+
+    void BM_ForEachPixel(::benchmark::State& state)
+    {
+        const auto width = static_cast<int>(state.range(0));
+        auto image = corpusImage(corpusKind::NOISE, width, width, static_cast<int>(state.range(1)));
+
+        for(auto _ : state)
+        {
+            image.forEachPixel([](std::uint8_t* pixel) { pixel[0] = static_cast<std::uint8_t>(255 - pixel[0]); });
+            ::benchmark::DoNotOptimize(image.constData());
+        }
+
+        setProcessed(state, image);
+    }
+    BENCHMARK(BM_ForEachPixel)->Apply(pixelArguments)->Unit(::benchmark::kMicrosecond);
+} // namespace
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <complex>
+#include <vector>
+
+#include "BenchmarkImages.hpp"
+#include "tgaImage/FFT.hpp"
+
+namespace
+{
+    using imageloader::benchmarks::imageBytes;
+    using imageloader::benchmarks::randomImage;
+
+    // Argument: transform side, powers of two and sizes with factors 3 and 5
+    void BM_FourierForward(::benchmark::State& state)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        const auto plan = imageloader::fourierPlan(side, side);
+        std::vector<float> samples(static_cast<std::size_t>(side)*side, 1.0f);
+        std::vector<std::complex<float>> spectrum(static_cast<std::size_t>(plan->spectrumWidth())*side);
+
+        for(auto _ : state)
+        {
+            plan->forward(samples.data(), static_cast<std::size_t>(side), spectrum.data());
+            ::benchmark::DoNotOptimize(spectrum.data());
+        }
+
+        state.SetItemsProcessed(state.iterations()*side*side);
+    }
+    BENCHMARK(BM_FourierForward)->Arg(512)->Arg(1000)->Arg(1024)->Arg(1080)->Arg(2048)->Unit(::benchmark::kMillisecond);
+
+    // Arguments: kernel side, bytes per pixel. A 1024x1024 image convolved with a kernel of equal weights.
+    void BM_ConvolveFFT(::benchmark::State& state)
+    {
+        const auto kernelSide = static_cast<int>(state.range(0));
+        const auto image = randomImage(1024, 1024, static_cast<int>(state.range(1)));
+        auto output = randomImage(1024, 1024, image.bitsPerPixel());
+        const std::vector<float> kernel(static_cast<std::size_t>(kernelSide)*kernelSide, 1.0f/static_cast<float>(kernelSide*kernelSide));
+
+        for(auto _ : state)
+        {
+            imageloader::convolveFFT(image.constView(), output.view(), kernel, kernelSide, kernelSide);
+            ::benchmark::DoNotOptimize(output.constData());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK(BM_ConvolveFFT)->ArgsProduct({{7, 15, 31, 63}, {1, 4}})->Unit(::benchmark::kMillisecond);
+
+    // Direct 2D convolution of a single channel for comparison, the cost the FFT path avoids for large kernels
+    void BM_ConvolveDirect(::benchmark::State& state)
+    {
+        const auto kernelSide = static_cast<int>(state.range(0));
+        const auto radius = kernelSide/2;
+        const auto image = randomImage(1024, 1024, 1);
+        auto output = randomImage(1024, 1024, 1);
+        const std::vector<float> kernel(static_cast<std::size_t>(kernelSide)*kernelSide, 1.0f/static_cast<float>(kernelSide*kernelSide));
+
+        const auto input = image.constView();
+        const auto result = output.view();
+        for(auto _ : state)
+        {
+            for(auto y = 0; y < input.height(); ++y)
+            {
+                for(auto x = 0; x < input.width(); ++x)
+                {
+                    auto sum = 0.0f;
+                    for(auto j = -radius; j <= radius; ++j)
+                    {
+                        const auto row = input.row(std::clamp(y + j, 0, input.height() - 1));
+                        for(auto i = -radius; i <= radius; ++i)
+                        {
+                            sum += kernel[static_cast<std::size_t>(j + radius)*kernelSide + i + radius]*row[std::clamp(x + i, 0, input.width() - 1)];
+                        }
+                    }
+                    result.row(y)[x] = static_cast<std::uint8_t>(std::clamp(sum + 0.5f, 0.0f, 255.0f));
+                }
+            }
+            ::benchmark::DoNotOptimize(output.constData());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK(BM_ConvolveDirect)->Arg(7)->Arg(15)->Arg(31)->Unit(::benchmark::kMillisecond);
+} // namespace
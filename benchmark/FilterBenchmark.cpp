@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkImages.hpp"
+#include "tgaImage/Filter.hpp"
+
+namespace
+{
+    using imageloader::benchmarks::imageBytes;
+    using imageloader::benchmarks::randomImage;
+
+    // Arguments: image side in pixels, bytes per pixel
+    void imageArguments(::benchmark::internal::Benchmark* benchmark)
+    {
+        for(const auto side : {1024, 4096})
+        {
+            for(const auto bytesPerPixel : {1, 4})
+            {
+                benchmark->Args({side, bytesPerPixel});
+            }
+        }
+    }
+
+    template<typename Filter>
+    void runFilter(::benchmark::State& state, Filter&& filter)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        const auto image = randomImage(side, side, static_cast<int>(state.range(1)));
+        auto output = randomImage(side, side, image.bitsPerPixel());
+
+        for(auto _ : state)
+        {
+            filter(image.constView(), output.view());
+            ::benchmark::DoNotOptimize(output.constData());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+
+    void BM_GaussianBlur(::benchmark::State& state, const float& sigma)
+    {
+        runFilter(state, [sigma](const auto& input, const auto& output)
+        {
+            imageloader::gaussianBlur(input, output, sigma);
+        });
+    }
+    BENCHMARK_CAPTURE(BM_GaussianBlur, sigma1, 1.0f)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+    BENCHMARK_CAPTURE(BM_GaussianBlur, sigma4, 4.0f)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+
+    void BM_BoxBlur(::benchmark::State& state)
+    {
+        runFilter(state, [](const auto& input, const auto& output)
+        {
+            imageloader::boxBlur(input, output, 3);
+        });
+    }
+    BENCHMARK(BM_BoxBlur)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+
+    void BM_Sharpen(::benchmark::State& state)
+    {
+        runFilter(state, [](const auto& input, const auto& output)
+        {
+            imageloader::sharpen(input, output, 1.0f, 1.0f);
+        });
+    }
+    BENCHMARK(BM_Sharpen)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+
+    // Downscaling to a quarter of the side
+    void BM_Downscale(::benchmark::State& state, const imageloader::resampleFilter& filter)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        const auto image = randomImage(side, side, static_cast<int>(state.range(1)));
+        auto output = randomImage(side/4, side/4, image.bitsPerPixel());
+
+        for(auto _ : state)
+        {
+            imageloader::resize(image.constView(), output.view(), filter);
+            ::benchmark::DoNotOptimize(output.constData());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK_CAPTURE(BM_Downscale, bilinear, imageloader::resampleFilter::BILINEAR)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+    BENCHMARK_CAPTURE(BM_Downscale, bicubic, imageloader::resampleFilter::BICUBIC)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+    BENCHMARK_CAPTURE(BM_Downscale, lanczos, imageloader::resampleFilter::LANCZOS)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+} // namespace
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+
+#include <variant>
+
+#include "BenchmarkImages.hpp"
+#include "tgaImage/Geometry.hpp"
+
+namespace
+{
+    using imageloader::benchmarks::imageBytes;
+    using imageloader::benchmarks::randomImage;
+
+    // Arguments: image side in pixels, bytes per pixel
+    void imageArguments(::benchmark::internal::Benchmark* benchmark)
+    {
+        for(const auto side : {1024, 4000, 4096})
+        {
+            for(const auto bytesPerPixel : {1, 2, 3, 4})
+            {
+                benchmark->Args({side, bytesPerPixel});
+            }
+        }
+    }
+
+    // Rotation through color()/setColor(), the baseline the tiled kernels replace
+    void BM_RotatePerPixel(::benchmark::State& state)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        const auto image = randomImage(side, side, static_cast<int>(state.range(1)));
+        auto output = randomImage(side, side, image.bitsPerPixel());
+
+        for(auto _ : state)
+        {
+            for(auto y = 0; y < side; ++y)
+            {
+                for(auto x = 0; x < side; ++x)
+                {
+                    output.setColor(side - 1 - y, x, std::get<imageloader::TGAColor>(image.color(x, y)));
+                }
+            }
+            ::benchmark::DoNotOptimize(output.constData());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK(BM_RotatePerPixel)->Args({1024, 4})->Unit(::benchmark::kMillisecond);
+
+    void BM_Transpose(::benchmark::State& state)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        const auto image = randomImage(side, side, static_cast<int>(state.range(1)));
+        auto output = randomImage(side, side, image.bitsPerPixel());
+
+        for(auto _ : state)
+        {
+            imageloader::transpose(image.constView(), output.view());
+            ::benchmark::DoNotOptimize(output.constData());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK(BM_Transpose)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+
+    void BM_Rotate(::benchmark::State& state, const imageloader::rotationAngle& angle)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        const auto image = randomImage(side, side, static_cast<int>(state.range(1)));
+        auto output = randomImage(side, side, image.bitsPerPixel());
+
+        for(auto _ : state)
+        {
+            imageloader::rotate(image.constView(), output.view(), angle);
+            ::benchmark::DoNotOptimize(output.constData());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK_CAPTURE(BM_Rotate, 90, imageloader::rotationAngle::DEGREES_90)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+    BENCHMARK_CAPTURE(BM_Rotate, 180, imageloader::rotationAngle::DEGREES_180)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+    BENCHMARK_CAPTURE(BM_Rotate, 270, imageloader::rotationAngle::DEGREES_270)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+
+    void BM_Rotate180InPlace(::benchmark::State& state)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        auto image = randomImage(side, side, static_cast<int>(state.range(1)));
+
+        for(auto _ : state)
+        {
+            image.rotate180();
+            ::benchmark::DoNotOptimize(image.constData());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK(BM_Rotate180InPlace)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+} // namespace
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <variant>
+
+#include "BenchmarkImages.hpp"
+#include "tgaImage/Statistics.hpp"
+
+namespace
+{
+    using imageloader::benchmarks::imageBytes;
+    using imageloader::benchmarks::randomImage;
+
+    // Arguments: image side in pixels, bytes per pixel
+    void imageArguments(::benchmark::internal::Benchmark* benchmark)
+    {
+        for(const auto side : {1024, 4096})
+        {
+            for(const auto bytesPerPixel : {1, 2, 3, 4})
+            {
+                benchmark->Args({side, bytesPerPixel});
+            }
+        }
+    }
+
+    // Histograms through color(), the way statistics were gathered before
+    void BM_HistogramPerPixel(::benchmark::State& state)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        const auto image = randomImage(side, side, static_cast<int>(state.range(1)));
+
+        for(auto _ : state)
+        {
+            std::array<std::array<std::uint64_t, 256>, 4> histograms{};
+            for(auto y = 0; y < side; ++y)
+            {
+                for(auto x = 0; x < side; ++x)
+                {
+                    const auto color = std::get<imageloader::TGAColor>(image.color(x, y));
+                    for(auto channel = 0; channel < color.bpp; ++channel)
+                    {
+                        ++histograms[channel][color.bgra[channel]];
+                    }
+                }
+            }
+            ::benchmark::DoNotOptimize(histograms.data());
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK(BM_HistogramPerPixel)->Args({1024, 4})->Unit(::benchmark::kMillisecond);
+
+    void BM_ComputeStatistics(::benchmark::State& state)
+    {
+        const auto side = static_cast<int>(state.range(0));
+        const auto image = randomImage(side, side, static_cast<int>(state.range(1)));
+
+        for(auto _ : state)
+        {
+            auto statistics = imageloader::computeStatistics(image);
+            ::benchmark::DoNotOptimize(statistics);
+        }
+
+        state.SetBytesProcessed(state.iterations()*imageBytes(image));
+    }
+    BENCHMARK(BM_ComputeStatistics)->Apply(imageArguments)->Unit(::benchmark::kMillisecond);
+} // namespace
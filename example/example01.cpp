@@ -18,7 +18,7 @@ int main(int argc, char** argv)
     utils::logger::infoMessage("Initializing image loader...");
     std::unique_ptr imagePointer = std::make_unique<imageloader::TGAImageLoader>();
 
-    utils::logger::infoMessage("Loading image with provided path: " + std::string{argv[1]});
+    utils::logger::infoMessage("Loading image with provided path: {}", argv[1]);
     auto loadResult = imagePointer->loadImage(argv[1]);
 
     if(std::holds_alternative<imageloader::ErrorCodes>(loadResult))
@@ -26,21 +26,18 @@ int main(int argc, char** argv)
         auto err = std::get<imageloader::ErrorCodes>(loadResult);
         if(err == imageloader::ErrorCodes::InvalidPath)
         {
-            utils::logger::setup(utils::constants::error);
             utils::logger::errorMessage("Invalid path provided!");
             return -1;
         }
 
         if(err == imageloader::ErrorCodes::InvalidReadOperation)
         {
-            utils::logger::setup(utils::constants::error);
             utils::logger::errorMessage("Read operation failed!");
             return -1;
         }
     }
     else
     {
-        utils::logger::setup("info");
         std::unique_ptr<imageloader::TGAImage> image{std::move(std::get<imageloader::TGAImage*>(loadResult))};
         if(image)
         {
@@ -10,6 +10,8 @@ namespace imageloader
         InvalidPath,
         UnableToOpenImage,
         InvalidReadOperation,
-        InvalidWriteOperation
+        InvalidWriteOperation,
+        ReadOnlyImage,
+        UnsupportedFormat
     };
 } // namespace imageloader
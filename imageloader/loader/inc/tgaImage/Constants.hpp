@@ -4,4 +4,6 @@
 namespace imageloader::tgaimage::constants
 {
     constexpr auto NUM_OF_CHANNELS = 4;
+    // Alignment of pixel buffers handed out by PixelAllocator, one cache line
+    constexpr auto PIXEL_BUFFER_ALIGNMENT = 64;
 } // namespace imageloader::tgaimage::constants
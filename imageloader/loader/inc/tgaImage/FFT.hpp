@@ -0,0 +1,90 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include "ErrorCodes.hpp"
+#include "ImageView.hpp"
+
+namespace imageloader
+{
+    class FourierPlanImpl;
+
+    // Factorization and twiddle factors of a 2D real-to-complex transform of width x height samples. Sizes of any
+    // length are supported, sizes with only 2, 3 and 5 as prime factors are the fastest. Plans are immutable and
+    // may be used by any number of threads at once.
+    class FourierPlan
+    {
+        public:
+            // width and height must be positive
+            FourierPlan(const int& width, const int& height);
+            ~FourierPlan();
+
+            FourierPlan(const FourierPlan&) = delete;
+            FourierPlan& operator=(const FourierPlan&) = delete;
+
+            int width() const;
+            int height() const;
+            // A row of real samples has width/2 + 1 independent frequencies, the others follow from symmetry
+            int spectrumWidth() const;
+
+            // input holds height rows of width samples, rowStride samples apart. spectrum receives height rows of
+            // spectrumWidth() bins, row v holds vertical frequency v, or v - height for the upper half of the rows.
+            void forward(const float* input, const std::size_t& rowStride, std::complex<float>* spectrum) const;
+            // Inverse of forward including the 1/(width*height) normalization, spectrum is overwritten
+            void inverse(std::complex<float>* spectrum, float* output, const std::size_t& rowStride) const;
+
+        private:
+            std::unique_ptr<FourierPlanImpl> d_ptr;
+    };
+
+    // Plans are cached by size, so images of the same size share their twiddle tables. nullptr for non-positive sizes.
+    std::shared_ptr<const FourierPlan> fourierPlan(const int& width, const int& height);
+    // Smallest size not below size with only 2, 3 and 5 as prime factors
+    int fastTransformSize(const int& size);
+
+    struct Spectrum
+    {
+        int width{0};
+        int height{0};
+        // height rows of width/2 + 1 bins, laid out as by FourierPlan::forward
+        std::vector<std::complex<float>> bins;
+    };
+
+    // Gain for the horizontal frequency u in [0, 0.5] and the vertical frequency v in [-0.5, 0.5), in cycles per pixel
+    using FrequencyResponse = std::function<float(const float& u, const float& v)>;
+
+    // Channels are bytes of a pixel, so 16 bit images are rejected with UnsupportedFormat like by the spatial filters
+    std::variant<Spectrum, ErrorCodes> channelSpectrum(const ConstImageView& image, const int& channel);
+    // Writes the rounded inverse transform into a channel of image, which has to be of the spectrum's size.
+    // The bins of spectrum are overwritten.
+    std::optional<ErrorCodes> spectrumToChannel(Spectrum& spectrum, const ImageView& image, const int& channel);
+    void applyResponse(Spectrum& spectrum, const FrequencyResponse& response);
+
+    // Multiplies the spectrum of every channel with response, the image wraps around at its edges
+    std::optional<ErrorCodes> filterFrequencies(const ConstImageView& input, const ImageView& output, const FrequencyResponse& response);
+
+    // output(x, y) = sum of kernel[j*kernelWidth + i]*input(x + i - kernelWidth/2, y + j - kernelHeight/2), pixels outside
+    // the image are copies of the nearest edge pixel as with the spatial filters. The kernel sides must be odd.
+    // Costs O(log(size)) per pixel independent of the kernel size, faster than direct convolution from about 15x15 taps.
+    std::optional<ErrorCodes> convolveFFT(const ConstImageView& input, const ImageView& output, const std::vector<float>& kernel,
+                                          const int& kernelWidth, const int& kernelHeight);
+
+    struct Translation
+    {
+        // moved(x, y) == reference(x - this->x, y - this->y), with subpixel precision
+        float x{0.0f};
+        float y{0.0f};
+        // Height of the correlation peak, 1 for a pure cyclic shift, close to 0 if the images do not match
+        float response{0.0f};
+    };
+
+    // Shift between two images of the same size from the phase of their cross power spectrum. Both images are
+    // Hann windowed to suppress their edges, shifts of up to half the image size in both directions are found.
+    std::variant<Translation, ErrorCodes> phaseCorrelation(const ConstImageView& reference, const ConstImageView& moved, const int& channel);
+} // namespace imageloader
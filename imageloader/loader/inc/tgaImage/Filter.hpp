@@ -0,0 +1,35 @@
+#pragma once
+
+#include <optional>
+#include <variant>
+
+#include "ErrorCodes.hpp"
+#include "ImageView.hpp"
+#include "TGAImage.hpp"
+
+namespace imageloader
+{
+    enum class resampleFilter
+    {
+        BILINEAR,
+        BICUBIC,
+        // Lanczos with 3 lobes
+        LANCZOS
+    };
+
+    // Spatial domain filters for 8, 24 and 32 bit images, every byte of a pixel is filtered as a separate channel.
+    // Alpha is filtered like the colors, convert to a premultiplied format first to keep transparent colors from bleeding.
+    // 16 bit images are rejected with UnsupportedFormat, their channels are not byte aligned.
+    // Input and output must not overlap. Pixels outside the image are treated as copies of the nearest edge pixel.
+
+    std::optional<ErrorCodes> gaussianBlur(const ConstImageView& input, const ImageView& output, const float& sigma);
+    // Mean of the (2*radius + 1)^2 pixels around every pixel
+    std::optional<ErrorCodes> boxBlur(const ConstImageView& input, const ImageView& output, const int& radius);
+    // Unsharp mask, output = input + amount*(input - gaussianBlur(input, sigma))
+    std::optional<ErrorCodes> sharpen(const ConstImageView& input, const ImageView& output, const float& amount, const float& sigma);
+
+    // Scales input to the size of output. When downscaling the filter is widened by the scale factor, so every input
+    // pixel contributes to the result.
+    std::optional<ErrorCodes> resize(const ConstImageView& input, const ImageView& output, const resampleFilter& filter);
+    std::variant<TGAImage, ErrorCodes> resizeImage(const TGAImage& image, const int& width, const int& height, const resampleFilter& filter);
+} // namespace imageloader
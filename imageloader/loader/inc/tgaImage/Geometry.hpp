@@ -0,0 +1,34 @@
+#pragma once
+
+#include <optional>
+#include <variant>
+
+#include "ErrorCodes.hpp"
+#include "ImageView.hpp"
+#include "TGAImage.hpp"
+
+namespace imageloader
+{
+    // Clockwise rotation
+    enum class rotationAngle
+    {
+        DEGREES_90,
+        DEGREES_180,
+        DEGREES_270
+    };
+
+    // Geometric operations work on pixels in memory order, i.e. as if the first stored pixel were the top-left one.
+    // Load with LoadOptions::normalizeOrigin to rotate images as they are displayed. Large images are processed in
+    // tiles that fit the cache, bands of tiles run on a shared worker pool.
+
+    // output is input.height() pixels wide and input.width() pixels high, the views must not overlap
+    std::optional<ErrorCodes> transpose(const ConstImageView& input, const ImageView& output);
+
+    // For 90 and 270 degrees the output dimensions are swapped and the views must not overlap.
+    // For 180 degrees input and output may be the same view, which rotates the image in place.
+    std::optional<ErrorCodes> rotate(const ConstImageView& input, const ImageView& output, const rotationAngle& angle);
+
+    // New images, width and height of the header follow the pixels
+    std::variant<TGAImage, ErrorCodes> transposeImage(const TGAImage& image);
+    std::variant<TGAImage, ErrorCodes> rotateImage(const TGAImage& image, const rotationAngle& angle);
+} // namespace imageloader
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <variant>
+
+#include "TGAImage.hpp"
+#include "TGAImageLoad.hpp"
+
+namespace imageloader
+{
+    class ImageCacheImpl;
+
+    struct ImageCacheUsage
+    {
+        std::size_t entries{0};
+        // Pixel bytes of the cached images
+        std::size_t bytes{0};
+        std::uint64_t hits{0};
+        std::uint64_t misses{0};
+        std::uint64_t evictions{0};
+    };
+
+    // Decoded images shared between callers, keyed by canonical path and validated against the size and
+    // modification time of the file on every lookup, so a rewritten file is decoded again. Once the pixels
+    // of all images exceed the byte budget, the least recently used ones are dropped. Concurrent misses on
+    // the same file wait for a single decode. All members may be called from any number of threads.
+    class ImageCache
+    {
+        public:
+            // loader decodes the misses and has to outlive the cache
+            ImageCache(TGAImageLoader& loader, const std::size_t& byteBudget);
+            ~ImageCache();
+
+            ImageCache(const ImageCache&) = delete;
+            ImageCache& operator=(const ImageCache&) = delete;
+
+            // Images are immutable and stay valid after they were evicted. Failed loads are not cached.
+            std::variant<std::shared_ptr<const TGAImage>, ErrorCodes> loadImage(const std::string_view& imagePath);
+
+            // Drops the cached images, handles already given out are not affected
+            void clear();
+            ImageCacheUsage usage() const;
+
+        private:
+            std::unique_ptr<ImageCacheImpl> d_ptr;
+    };
+} // namespace imageloader
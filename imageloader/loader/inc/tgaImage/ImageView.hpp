@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace imageloader
+{
+    // Non-owning view of pixel rows. Rows are rowStride bytes apart, so a view may describe a sub-rectangle
+    // of a larger image. PixelType is std::uint8_t for mutable and const std::uint8_t for read-only views.
+    template<typename PixelType>
+    class BasicImageView
+    {
+        static_assert(std::is_same_v<std::remove_const_t<PixelType>, std::uint8_t>, "Image views are byte based");
+
+        public:
+            class RowIterator
+            {
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type = PixelType*;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = PixelType**;
+                    using reference = PixelType*;
+
+                    RowIterator(PixelType* row, const std::size_t& rowStride) : row{row}, rowStride{rowStride}
+                    {
+
+                    }
+
+                    PixelType* operator*() const
+                    {
+                        return row;
+                    }
+
+                    RowIterator& operator++()
+                    {
+                        row += rowStride;
+                        return *this;
+                    }
+
+                    RowIterator operator++(int)
+                    {
+                        auto current = *this;
+                        ++(*this);
+                        return current;
+                    }
+
+                    bool operator==(const RowIterator& rhs) const
+                    {
+                        return row == rhs.row;
+                    }
+
+                    bool operator!=(const RowIterator& rhs) const
+                    {
+                        return row != rhs.row;
+                    }
+
+                private:
+                    PixelType* row{nullptr};
+                    std::size_t rowStride{0};
+            };
+
+            BasicImageView() = default;
+
+            BasicImageView(PixelType* data, const int& width, const int& height, const int& bytesPerPixel, const std::size_t& rowStride) :
+                            pixels{data},
+                            viewWidth{width},
+                            viewHeight{height},
+                            pixelSize{bytesPerPixel},
+                            stride{rowStride}
+            {
+
+            }
+
+            // Tightly packed rows
+            BasicImageView(PixelType* data, const int& width, const int& height, const int& bytesPerPixel) :
+                            BasicImageView{data, width, height, bytesPerPixel, static_cast<std::size_t>(width)*bytesPerPixel}
+            {
+
+            }
+
+            // Mutable views convert to read-only ones
+            template<typename OtherType, typename = std::enable_if_t<std::is_same_v<const OtherType, PixelType> &&
+                                                                     !std::is_same_v<OtherType, PixelType>>>
+            BasicImageView(const BasicImageView<OtherType>& other) :
+                            BasicImageView{other.data(), other.width(), other.height(), other.bytesPerPixel(), other.rowStride()}
+            {
+
+            }
+
+            PixelType* data() const
+            {
+                return pixels;
+            }
+
+            int width() const
+            {
+                return viewWidth;
+            }
+
+            int height() const
+            {
+                return viewHeight;
+            }
+
+            int bytesPerPixel() const
+            {
+                return pixelSize;
+            }
+
+            std::size_t rowStride() const
+            {
+                return stride;
+            }
+
+            // Bytes of pixel data in a single row, without padding up to rowStride
+            std::size_t rowSize() const
+            {
+                return static_cast<std::size_t>(viewWidth)*pixelSize;
+            }
+
+            bool empty() const
+            {
+                return pixels == nullptr || viewWidth <= 0 || viewHeight <= 0;
+            }
+
+            // True if rows follow each other without gaps, so the whole view is a single block of memory
+            bool isContiguous() const
+            {
+                return stride == rowSize();
+            }
+
+            PixelType* row(const int& y) const
+            {
+                return pixels + y*stride;
+            }
+
+            PixelType* pixel(const int& x, const int& y) const
+            {
+                return row(y) + static_cast<std::size_t>(x)*pixelSize;
+            }
+
+            // Sub-rectangle sharing the same pixels, clipped to the bounds of this view
+            BasicImageView crop(const int& x, const int& y, const int& width, const int& height) const
+            {
+                const auto left = std::clamp(x, 0, viewWidth);
+                const auto top = std::clamp(y, 0, viewHeight);
+                const auto right = std::clamp(x + std::max(width, 0), left, viewWidth);
+                const auto bottom = std::clamp(y + std::max(height, 0), top, viewHeight);
+
+                if(right == left || bottom == top)
+                {
+                    return BasicImageView{};
+                }
+
+                return BasicImageView{pixel(left, top), right - left, bottom - top, pixelSize, stride};
+            }
+
+            BasicImageView rows(const int& firstRow, const int& rowCount) const
+            {
+                return crop(0, firstRow, viewWidth, rowCount);
+            }
+
+            RowIterator begin() const
+            {
+                return RowIterator{pixels, stride};
+            }
+
+            RowIterator end() const
+            {
+                return RowIterator{empty() ? pixels : row(viewHeight), stride};
+            }
+
+        private:
+            PixelType* pixels{nullptr};
+            int viewWidth{0};
+            int viewHeight{0};
+            int pixelSize{0};
+            std::size_t stride{0};
+    };
+
+    using ImageView = BasicImageView<std::uint8_t>;
+    using ConstImageView = BasicImageView<const std::uint8_t>;
+} // namespace imageloader
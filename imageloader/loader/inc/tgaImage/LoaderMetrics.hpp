@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace imageloader
+{
+    // Steps of loading and storing an image that are timed separately
+    enum class loadStage
+    {
+        // std::filesystem checks of image paths and directories
+        PATH_CHECK,
+        // Opening or mapping a file
+        OPEN,
+        // Reading and parsing the header, ID field and footer
+        HEADER,
+        // Allocating pixel storage
+        ALLOCATE,
+        // Reading pixel data, from the file or from the buffer passed to decode
+        READ,
+        // RLE decoding
+        DECODE,
+        // Pixel format conversion, reorientation and statistics while loading
+        CONVERT,
+        // RLE encoding
+        ENCODE,
+        // Writing encoded bytes to the file
+        WRITE,
+        COUNT
+    };
+
+    constexpr std::size_t loadStageCount = static_cast<std::size_t>(loadStage::COUNT);
+
+    // Lowercase name of the stage as used in traces, e.g. "decode"
+    const char* loadStageName(const loadStage& stage);
+
+    // Cumulative counters of a loader since it was created or reset, indexed by loadStage
+    struct LoaderMetrics
+    {
+        // Time spent in a stage itself, a stage running inside another one is only counted for the inner stage
+        std::array<std::uint64_t, loadStageCount> stageNanoseconds{};
+        std::array<std::uint64_t, loadStageCount> stageCalls{};
+        std::uint64_t bytesRead{0};
+        std::uint64_t bytesWritten{0};
+        std::uint64_t packetsDecoded{0};
+        std::uint64_t allocations{0};
+        std::uint64_t allocatedBytes{0};
+        std::uint64_t imagesLoaded{0};
+        std::uint64_t imagesStored{0};
+    };
+} // namespace imageloader
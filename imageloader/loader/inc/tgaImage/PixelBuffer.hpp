@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace imageloader
+{
+    // Source of pixel storage. Returned memory is aligned to PIXEL_BUFFER_ALIGNMENT and not initialized.
+    class PixelAllocator
+    {
+        public:
+            virtual ~PixelAllocator() = default;
+
+            virtual std::uint8_t* allocate(const std::size_t& size) = 0;
+            virtual void deallocate(std::uint8_t* data, const std::size_t& size) = 0;
+    };
+
+    // Allocator used when the caller does not supply one, every call goes to aligned operator new/delete
+    std::shared_ptr<PixelAllocator> defaultPixelAllocator();
+
+    // Keeps released buffers and hands them out again for requests of the same size, so decoding
+    // same-sized frames does not touch the system allocator. At most maxCachedBytes are kept around.
+    class BufferPool : public PixelAllocator
+    {
+        public:
+            explicit BufferPool(const std::size_t& maxCachedBytes);
+            ~BufferPool() override;
+
+            std::uint8_t* allocate(const std::size_t& size) override;
+            void deallocate(std::uint8_t* data, const std::size_t& size) override;
+
+            std::size_t cachedBytes() const;
+            // Frees all cached buffers, buffers in use are not affected
+            void trim();
+
+        private:
+            std::size_t maxCachedBytes{0};
+            std::size_t currentCachedBytes{0};
+            std::unordered_map<std::size_t, std::vector<std::uint8_t*>> freeBuffers;
+            mutable std::mutex mutex;
+    };
+
+    // Owning handle to allocator provided pixel storage, the memory goes back to the allocator on destruction.
+    // Copies allocate from the same allocator.
+    class PixelBuffer
+    {
+        public:
+            PixelBuffer() = default;
+            PixelBuffer(std::shared_ptr<PixelAllocator> allocator, const std::size_t& size);
+            ~PixelBuffer();
+
+            PixelBuffer(const PixelBuffer& rhs);
+            PixelBuffer(PixelBuffer&& rhs) noexcept;
+            PixelBuffer& operator=(const PixelBuffer& rhs);
+            PixelBuffer& operator=(PixelBuffer&& rhs) noexcept;
+
+            std::uint8_t* data() const;
+            std::size_t size() const;
+            explicit operator bool() const;
+
+        private:
+            void reset();
+
+        private:
+            std::shared_ptr<PixelAllocator> allocator;
+            std::uint8_t* buffer{nullptr};
+            std::size_t length{0};
+    };
+} // namespace imageloader
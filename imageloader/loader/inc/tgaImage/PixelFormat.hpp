@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <variant>
+
+#include "ErrorCodes.hpp"
+#include "ImageView.hpp"
+#include "TGAImage.hpp"
+
+namespace imageloader
+{
+    // Memory layout of a pixel, channels are listed in the order of their bytes
+    enum class pixelFormat
+    {
+        GRAY,
+        // 16 bit little endian pixels, 5 bits per color channel, the top bit is ignored
+        BGR555,
+        // As BGR555, the top bit is a 1 bit alpha channel
+        BGRA5551,
+        BGR,
+        RGB,
+        BGRA,
+        RGBA,
+        // Color channels are multiplied by alpha
+        BGRA_PREMULTIPLIED,
+        RGBA_PREMULTIPLIED
+    };
+
+    int bytesPerPixel(const pixelFormat& format);
+    int channelCount(const pixelFormat& format);
+
+    // Format in which the pixels described by a TGA header are stored
+    std::variant<pixelFormat, ErrorCodes> nativePixelFormat(const TGAHeader& header);
+
+    // Converts pixelCount pixels. Input and output may only overlap if they are the same buffer and both formats
+    // have the same number of bytes per pixel. Gray values are computed with BT.601 weights, premultiplied sources
+    // are divided by alpha before being written to a straight alpha or gray format.
+    std::optional<ErrorCodes> convertPixels(const std::uint8_t* input, const pixelFormat& inputFormat,
+                                            std::uint8_t* output, const pixelFormat& outputFormat, const std::size_t& pixelCount);
+
+    // Scalar implementation of convertPixels, the vectorized kernels produce exactly the same bytes
+    std::optional<ErrorCodes> convertPixelsReference(const std::uint8_t* input, const pixelFormat& inputFormat,
+                                                     std::uint8_t* output, const pixelFormat& outputFormat, const std::size_t& pixelCount);
+
+    // Row by row conversion, both views must have the same dimensions and match the bytes per pixel of their format
+    std::optional<ErrorCodes> convertPixels(const ConstImageView& input, const pixelFormat& inputFormat,
+                                            const ImageView& output, const pixelFormat& outputFormat);
+
+    // New image holding the pixels of image in the given format. The header keeps the image type and origin,
+    // bits per pixel and alpha bits follow the format.
+    std::variant<TGAImage, ErrorCodes> convertImage(const TGAImage& image, const pixelFormat& format);
+
+    // One plane of width*height floats in [0, 1] per channel of planeFormat, planes follow each other in the order of
+    // the channels (e.g. R, G, B for pixelFormat::RGB). Output holds channelCount(planeFormat)*width*height floats.
+    std::optional<ErrorCodes> convertToPlanarFloat(const ConstImageView& input, const pixelFormat& inputFormat,
+                                                   float* output, const pixelFormat& planeFormat);
+} // namespace imageloader
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include "ErrorCodes.hpp"
+#include "ImageView.hpp"
+#include "PixelFormat.hpp"
+#include "TGAImage.hpp"
+
+namespace imageloader
+{
+    struct ChannelStatistics
+    {
+        std::array<std::uint64_t, 256> histogram{};
+        std::uint8_t minimum{0};
+        std::uint8_t maximum{0};
+        double mean{0.0};
+        // Population variance
+        double variance{0.0};
+    };
+
+    struct ImageStatistics
+    {
+        std::uint64_t pixelCount{0};
+        // Channels in the byte order of the pixel format, e.g. B, G, R, A for pixelFormat::BGRA. Channels of the 16 bit
+        // formats are expanded to 8 bits as by convertPixels, their alpha bit counts as 0 or 255.
+        std::vector<ChannelStatistics> channels;
+        // If set, alpha is the last channel
+        bool hasAlpha{false};
+        // Mean alpha relative to 255, 1 for formats without alpha
+        double alphaCoverage{1.0};
+        std::uint64_t transparentPixels{0};
+        std::uint64_t opaquePixels{0};
+    };
+
+    // Histograms of pixels added in any number of calls. Everything else is derived from the histograms, so adding
+    // pixels costs one table increment per channel. Accumulators of separate threads are combined with merge.
+    class StatisticsAccumulator
+    {
+        public:
+            explicit StatisticsAccumulator(const pixelFormat& format);
+
+            // pixelCount pixels of the accumulator's format
+            void add(const std::uint8_t* pixels, const std::size_t& pixelCount);
+            void merge(const StatisticsAccumulator& other);
+
+            const pixelFormat& format() const;
+            ImageStatistics statistics() const;
+
+        private:
+            void flush();
+
+        private:
+            pixelFormat pixelsFormat;
+            int channels{0};
+            // Four interleaved 32 bit tables per channel, consecutive pixels count into different tables, so runs
+            // of equal values do not wait for the previous increment of the same counter
+            std::vector<std::uint32_t> tables;
+            std::size_t pendingPixels{0};
+            std::vector<std::uint64_t> totals;
+            std::uint64_t pixelCount{0};
+    };
+
+    // Bands of rows are counted in parallel on the processing pool, each into its own histograms
+    std::variant<ImageStatistics, ErrorCodes> computeStatistics(const ConstImageView& image, const pixelFormat& format);
+    // Statistics of the image in the format given by its header
+    std::variant<ImageStatistics, ErrorCodes> computeStatistics(const TGAImage& image);
+} // namespace imageloader
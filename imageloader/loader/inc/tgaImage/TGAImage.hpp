@@ -1,7 +1,9 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <variant>
@@ -9,6 +11,8 @@
 
 #include "Constants.hpp"
 #include "ErrorCodes.hpp"
+#include "ImageView.hpp"
+#include "PixelBuffer.hpp"
 
 namespace imageloader
 {
@@ -46,23 +50,50 @@ namespace imageloader
     };
 
     class TGAImageImpl;
+    class TGAImage;
+
+    // Produces the pixels of a lazily loaded image, called at most once
+    using PixelDecoder = std::function<std::variant<TGAImage*, ErrorCodes>()>;
 
     class TGAImage
     {
         public:
             TGAImage();
             TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header,const std::vector<std::uint8_t>& imageData);
+            // Takes over the pixel buffer, no copy is made
+            TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header, std::vector<std::uint8_t>&& imageData);
+            // Pixels live in allocator provided storage which is released to its allocator with the image
+            TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header, PixelBuffer&& imageData);
+            // Read-only image backed by external storage (e.g. a memory mapped file), pixels are not copied
+            TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header,
+                     std::shared_ptr<const std::uint8_t> imageView, const std::size_t& viewSize);
+            // Lazy image, decoder runs on the first access to the pixels. It has to return an image of the given size and
+            // bits per pixel. Width, height, bits per pixel, header and dataSize() are available without decoding.
+            TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header, PixelDecoder decoder);
             ~TGAImage();
+            // Copies own a separate pixel buffer, read-only images share their view. Lazy images are decoded before they are copied.
             TGAImage(const TGAImage& rhs);
-            TGAImage(TGAImage&& rhs);
+            // A moved-from image may only be assigned to or destroyed
+            TGAImage(TGAImage&& rhs) noexcept;
 
             TGAImage& operator=(const TGAImage& image);
+            TGAImage& operator=(TGAImage&& image) noexcept;
 
             int width() const;
             int height() const;
             int bitsPerPixel() const;
             int dataSize() const;
+            // Returns nullptr for read-only images, use constData() to access their pixels
             std::uint8_t* data() const;
+            const std::uint8_t* constData() const;
+            bool isReadOnly() const;
+            // Decodes a lazy image if that has not happened yet. If decoding failed, the pixels are zero and the error
+            // is returned here and by color().
+            std::optional<ErrorCodes> decodeError() const;
+
+            // Zero-copy views of the whole image, view() is empty for read-only images
+            ImageView view();
+            ConstImageView constView() const;
 
 
             std::variant<TGAColor, ErrorCodes> color(const int& x, const int& y) const;
@@ -70,6 +101,61 @@ namespace imageloader
             void setHeader(const TGAHeader&& header);
             TGAHeader getHeader() const;
 
+            // Bulk counterparts of color()/setColor(), rectangles are checked against the image once per call
+            std::optional<ErrorCodes> fillRect(const int& x, const int& y, const int& width, const int& height, const TGAColor& colorValue);
+            std::variant<TGAImage, ErrorCodes> copyRect(const int& x, const int& y, const int& width, const int& height) const;
+            // Copies a rectangle of source to (dstX, dstY), source may be this image and the rectangles may overlap
+            std::optional<ErrorCodes> blit(const TGAImage& source, const int& srcX, const int& srcY, const int& width, const int& height,
+                                           const int& dstX, const int& dstY);
+            // output/input hold width()*bitsPerPixel() bytes
+            std::optional<ErrorCodes> readRow(const int& y, std::uint8_t* output) const;
+            std::optional<ErrorCodes> writeRow(const int& y, const std::uint8_t* input);
+
+            // In-place mirroring of the pixels, the header is left as it is
+            std::optional<ErrorCodes> flipHorizontally();
+            std::optional<ErrorCodes> flipVertically();
+            // In-place rotation by 180 degrees, large images are processed on multiple threads
+            std::optional<ErrorCodes> rotate180();
+            // Reorders the pixels so the first one is the top-left pixel and marks the header accordingly
+            std::optional<ErrorCodes> normalizeOrigin();
+
+            // Calls function(std::uint8_t* pixel) for every pixel of the rectangle, row by row
+            template<typename Function>
+            std::optional<ErrorCodes> forEachPixel(const int& x, const int& y, const int& width, const int& height, Function&& function)
+            {
+                if(!containsRect(x, y, width, height))
+                {
+                    return ErrorCodes::IndexOutOfRange;
+                }
+
+                if(isReadOnly())
+                {
+                    return ErrorCodes::ReadOnlyImage;
+                }
+
+                const auto region = view().crop(x, y, width, height);
+                const auto bytesPerPixel = region.bytesPerPixel();
+                for(auto row : region)
+                {
+                    const auto rowEnd = row + region.rowSize();
+                    for(auto pixel = row; pixel < rowEnd; pixel += bytesPerPixel)
+                    {
+                        function(pixel);
+                    }
+                }
+
+                return std::nullopt;
+            }
+
+            template<typename Function>
+            std::optional<ErrorCodes> forEachPixel(Function&& function)
+            {
+                return forEachPixel(0, 0, width(), height(), std::forward<Function>(function));
+            }
+
+        private:
+            bool containsRect(const int& x, const int& y, const int& width, const int& height) const;
+
         private:
             std::unique_ptr<TGAImageImpl> d_ptr;
     };
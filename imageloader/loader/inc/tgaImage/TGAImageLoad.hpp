@@ -1,9 +1,18 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <variant>
+#include <vector>
 
+#include "LoaderMetrics.hpp"
+#include "PixelFormat.hpp"
+#include "Statistics.hpp"
 #include "TGAImage.hpp"
 
 namespace imageloader
@@ -13,18 +22,125 @@ namespace imageloader
     enum class compressionStatus
     {
         NO,
-        YES
+        YES,
+        // RLE compressed, bands of rows are encoded concurrently on the worker pool
+        PARALLEL
     };
 
+    enum class loadMode
+    {
+        // Pixels are read into a buffer owned by the image
+        COPY,
+        // Uncompressed images are exposed as a read-only view of the mapped file, compressed images are decoded as with COPY
+        MEMORY_MAPPED,
+        // Only the header is read, pixels are decoded as with COPY on the first access to them
+        LAZY
+    };
+
+    // How batch operations reach the files
+    enum class ioBackend
+    {
+        // Every worker reads and writes its own file with blocking stream calls
+        BLOCKING,
+        // Whole files are transferred with pread/pwrite on a dedicated pool of I/O threads
+        THREAD_POOL,
+        // Whole files are transferred through an io_uring on Linux, THREAD_POOL where it is not available
+        IO_URING
+    };
+
+    // Everything known about an image file without decoding its pixels
+    struct ImageInfo
+    {
+        TGAHeader header;
+        // Contents of the image ID field
+        std::string id;
+        // Set for TGA 2.0 files, the offsets of their extension and developer areas are 0 if the areas are absent
+        bool hasFooter{false};
+        std::uint32_t extensionOffset{0};
+        std::uint32_t developerOffset{0};
+        std::uintmax_t fileSize{0};
+    };
+
+    // Receives the statistics of a loaded image, batch loads call it from their worker threads
+    using StatisticsSink = std::function<void(const std::string_view& imagePath, const ImageStatistics& statistics)>;
+
+    struct LoadOptions
+    {
+        // Images that have to be converted or reoriented are always decoded into a buffer owned by the image.
+        // The statistics of lazy images are reported when they are decoded.
+        loadMode mode{loadMode::COPY};
+        // Pixels are converted block by block while they are decoded, the image never exists in its stored format as a whole.
+        // As with convertImage, bits per pixel and alpha bits of the returned header follow the format.
+        std::optional<pixelFormat> format;
+        // Rows are placed top-down and pixels left to right while decoding, the returned header has a top-left origin
+        bool normalizeOrigin{false};
+        // If set, statistics of the returned pixels are counted block by block while the pixels are decoded, so they
+        // are never read a second time. Not called for failed loads and formats nativePixelFormat does not know.
+        StatisticsSink statistics;
+    };
+
+    // Receives encoded bytes in order, returns false if they could not be consumed
+    using ByteSink = std::function<bool(const std::uint8_t* data, const std::size_t& size)>;
+
     class TGAImageLoader
     {
         public:
             TGAImageLoader();
+            // Number of worker threads used by batch operations, 0 selects the number of hardware threads
+            explicit TGAImageLoader(const unsigned int& workerCount);
             ~TGAImageLoader();
 
             std::variant<TGAImage*, ErrorCodes> loadImage(const std::string_view& imagePath);
+            std::variant<TGAImage*, ErrorCodes> loadImage(const std::string_view& imagePath, const loadMode& mode);
+            // Same as loadImage(imagePath, LoadOptions{loadMode::COPY, format, false, nullptr})
+            std::variant<TGAImage*, ErrorCodes> loadImage(const std::string_view& imagePath, const pixelFormat& format);
+            std::variant<TGAImage*, ErrorCodes> loadImage(const std::string_view& imagePath, const LoadOptions& options);
+
+            // Decodes all images on the worker pool, results are returned in the order of imagePaths. With an ioBackend other
+            // than BLOCKING, COPY loads without format or origin changes read whole files asynchronously and decode them
+            // while the following reads are in flight.
+            std::vector<std::variant<TGAImage*, ErrorCodes>> loadImages(const std::vector<std::string>& imagePaths);
+            std::vector<std::variant<TGAImage*, ErrorCodes>> loadImages(const std::vector<std::string>& imagePaths, const loadMode& mode);
+            std::vector<std::variant<TGAImage*, ErrorCodes>> loadImages(const std::vector<std::string>& imagePaths, const LoadOptions& options);
+            // Reads the header, ID field and footer only, the pixel data is never touched
+            std::variant<ImageInfo, ErrorCodes> probeImage(const std::string_view& imagePath);
+            // Probes all images on the worker pool, results are returned in the order of imagePaths
+            std::vector<std::variant<ImageInfo, ErrorCodes>> probeImages(const std::vector<std::string>& imagePaths);
+
             std::variant<std::string, ErrorCodes> storeImage(const std::string_view& imagePath, const TGAImage& image);
             std::variant<std::string, ErrorCodes> storeImage(const std::string_view& imagePath, const TGAImage& image, const compressionStatus& status);
+            // Stores images[index] at imagePaths[index] on the worker pool, results are returned in the order of imagePaths.
+            // With an ioBackend other than BLOCKING, images are encoded in memory and written while the next ones are encoded.
+            std::vector<std::variant<std::string, ErrorCodes>> storeImages(const std::vector<std::string>& imagePaths,
+                                                                           const std::vector<const TGAImage*>& images);
+            std::vector<std::variant<std::string, ErrorCodes>> storeImages(const std::vector<std::string>& imagePaths,
+                                                                           const std::vector<const TGAImage*>& images,
+                                                                           const compressionStatus& status);
+
+            // Backend of loadImages and storeImages with up to queueDepth file transfers in flight, BLOCKING by default.
+            // Returns the backend actually used. Single loads and stores always block. Must not be changed while batches run.
+            ioBackend setIOBackend(const ioBackend& backend, const unsigned int& queueDepth = 64);
+
+            // Storage for decoded pixels, e.g. a BufferPool shared between loaders. nullptr restores the default allocator.
+            // Must not be changed while loads are in flight.
+            void setPixelAllocator(std::shared_ptr<PixelAllocator> allocator);
+
+            // In-memory counterparts of loadImage/storeImage, the filesystem is never touched
+            std::variant<TGAImage*, ErrorCodes> decode(const std::uint8_t* data, const std::size_t& size);
+            std::optional<ErrorCodes> encode(const TGAImage& image, std::vector<std::uint8_t>& output);
+            std::optional<ErrorCodes> encode(const TGAImage& image, std::vector<std::uint8_t>& output, const compressionStatus& status);
+            std::optional<ErrorCodes> encode(const TGAImage& image, const ByteSink& sink, const compressionStatus& status);
+
+            // Per-stage timings and counters of all operations of this loader, including lazy images it returned.
+            // Off by default. Libraries built without IMAGELOADER_METRICS never record anything.
+            void enableMetrics(const bool& enabled);
+            LoaderMetrics metrics() const;
+            // Clears the counters and the recorded trace
+            void resetMetrics();
+            // While enabled, every timed stage is recorded as a trace span as well
+            void enableTracing(const bool& enabled);
+            // Chrome trace event file of the recorded spans, opened by chrome://tracing and the Perfetto UI
+            std::optional<ErrorCodes> writeTrace(const std::string_view& tracePath) const;
 
         private:
             bool verifyDirectoryExistence(const std::string_view& imagePath);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <variant>
+
+#include "TGAImage.hpp"
+
+namespace imageloader
+{
+    class TGAScanlineReaderImpl;
+
+    // Reads an image band by band without materializing it. Rows are always returned top to bottom
+    // with pixels left to right, regardless of the origin stored in TGAHeader::imagedescriptor.
+    // Memory use is bounded by the read block and the band passed in by the caller; bottom-left RLE
+    // images additionally keep a small per-row index built when the file is opened.
+    class TGAScanlineReader
+    {
+        public:
+            TGAScanlineReader();
+            ~TGAScanlineReader();
+
+            std::optional<ErrorCodes> open(const std::string_view& imagePath);
+            void close();
+
+            TGAHeader header() const;
+            int width() const;
+            int height() const;
+            int bitsPerPixel() const;
+            std::size_t rowSize() const;
+            // Index of the next row returned by readRows, counted from the top
+            int currentRow() const;
+
+            // Reads up to rowCount rows into output, which must hold rowCount*rowSize() bytes.
+            // Returns the number of rows read, 0 once all rows were read.
+            std::variant<int, ErrorCodes> readRows(std::uint8_t* output, const int& rowCount);
+
+        private:
+            std::unique_ptr<TGAScanlineReaderImpl> d_ptr;
+    };
+} // namespace imageloader
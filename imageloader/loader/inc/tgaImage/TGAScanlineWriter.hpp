@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "TGAImage.hpp"
+#include "TGAImageLoad.hpp"
+
+namespace imageloader
+{
+    class TGAScanlineWriterImpl;
+
+    // Writes an image band by band, memory use is bounded by a single output block.
+    // Rows are accepted top to bottom, so the stored header always carries the top-left origin.
+    // RLE packets never cross rows, PARALLEL compression is handled like YES.
+    class TGAScanlineWriter
+    {
+        public:
+            TGAScanlineWriter();
+            // Closes the writer, an incomplete file is removed
+            ~TGAScanlineWriter();
+
+            std::optional<ErrorCodes> open(const std::string_view& imagePath, const TGAHeader& header, const compressionStatus& status);
+            // Appends rowCount rows of header.width pixels, rows has to hold rowCount*rowSize() bytes
+            std::optional<ErrorCodes> writeRows(const std::uint8_t* rows, const int& rowCount);
+            // Flushes pending data, fails and removes the file if not all rows were written
+            std::optional<ErrorCodes> close();
+
+            std::size_t rowSize() const;
+            // Index of the next row expected by writeRows, counted from the top
+            int currentRow() const;
+
+        private:
+            std::unique_ptr<TGAScanlineWriterImpl> d_ptr;
+    };
+} // namespace imageloader
@@ -0,0 +1,559 @@
+#include "AsyncFileIO.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+
+    #include "ThreadPool.hpp"
+#endif
+
+#if defined(IMAGELOADER_IO_URING)
+    #include <cstring>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+namespace imageloader
+{
+#if defined(_WIN32)
+    std::unique_ptr<AsyncFileIO> AsyncFileIO::create(const ioBackend&, const unsigned int&)
+    {
+        return nullptr;
+    }
+#else
+    namespace
+    {
+        // Keeps single transfers within the range of the int results of io_uring
+        constexpr std::size_t maxTransferSize = std::size_t{1} << 30;
+        constexpr unsigned int maxQueueDepth = 4096;
+
+        struct FileRequest
+        {
+            int descriptor{-1};
+            bool write{false};
+            std::uint8_t* data{nullptr};
+            std::size_t size{0};
+            std::size_t transferred{0};
+            // errno of the failed transfer, 0 if none failed
+            int error{0};
+            // Only the buffer of reads is owned by the request
+            std::unique_ptr<std::uint8_t[]> buffer;
+            ReadCompletion readCompletion;
+            WriteCompletion writeCompletion;
+            iovec vector{};
+        };
+
+        // Opens files and limits the requests in flight, derived classes only transfer the bytes of a request
+        class PosixFileIO : public AsyncFileIO
+        {
+            public:
+                explicit PosixFileIO(const unsigned int& queueDepth) : depth{queueDepth}
+                {
+
+                }
+
+                unsigned int queueDepth() const override
+                {
+                    return depth;
+                }
+
+                std::optional<ErrorCodes> readFile(const std::string& filePath, ReadCompletion completion) override
+                {
+                    acquireSlot();
+
+                    const auto descriptor = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+                    if(descriptor < 0)
+                    {
+                        releaseSlot();
+                        return ErrorCodes::UnableToOpenImage;
+                    }
+
+                    struct stat fileStatus{};
+                    if(fstat(descriptor, &fileStatus) != 0 || fileStatus.st_size < 0)
+                    {
+                        ::close(descriptor);
+                        releaseSlot();
+                        return ErrorCodes::InvalidReadOperation;
+                    }
+
+                    auto request = new FileRequest{};
+                    request->descriptor = descriptor;
+                    request->size = static_cast<std::size_t>(fileStatus.st_size);
+                    request->buffer.reset(new std::uint8_t[std::max<std::size_t>(request->size, 1)]);
+                    request->data = request->buffer.get();
+                    request->readCompletion = std::move(completion);
+                    transfer(request);
+                    return std::nullopt;
+                }
+
+                std::optional<ErrorCodes> writeFile(const std::string& filePath, const std::uint8_t* data, const std::size_t& size,
+                                                    WriteCompletion completion) override
+                {
+                    acquireSlot();
+
+                    const auto descriptor = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+                    if(descriptor < 0)
+                    {
+                        releaseSlot();
+                        return ErrorCodes::UnableToOpenImage;
+                    }
+
+                    auto request = new FileRequest{};
+                    request->descriptor = descriptor;
+                    request->write = true;
+                    request->data = const_cast<std::uint8_t*>(data);
+                    request->size = size;
+                    request->writeCompletion = std::move(completion);
+                    transfer(request);
+                    return std::nullopt;
+                }
+
+            protected:
+                // Starts moving the bytes [transferred, size) of the request, complete is called once they are done or failed
+                virtual void transfer(FileRequest* request) = 0;
+
+                // Closing may report a write error late, e.g. on network filesystems
+                void complete(FileRequest* request)
+                {
+                    if(::close(request->descriptor) != 0 && request->error == 0)
+                    {
+                        request->error = errno;
+                    }
+
+                    if(request->write)
+                    {
+                        const auto failed = request->error != 0 || request->transferred != request->size;
+                        request->writeCompletion(failed ? std::optional<ErrorCodes>{ErrorCodes::InvalidWriteOperation} : std::nullopt);
+                    }
+                    else if(request->error != 0)
+                    {
+                        request->readCompletion(ErrorCodes::InvalidReadOperation);
+                    }
+                    else
+                    {
+                        request->readCompletion(FileContents{std::move(request->buffer), request->transferred});
+                    }
+
+                    delete request;
+                    releaseSlot();
+                }
+
+            private:
+                void acquireSlot()
+                {
+                    std::unique_lock<std::mutex> lock{slotMutex};
+                    slotFreed.wait(lock, [this]() { return inFlight < depth; });
+                    ++inFlight;
+                }
+
+                void releaseSlot()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock{slotMutex};
+                        --inFlight;
+                    }
+                    slotFreed.notify_one();
+                }
+
+            private:
+                unsigned int depth{1};
+                unsigned int inFlight{0};
+                std::mutex slotMutex;
+                std::condition_variable slotFreed;
+        };
+
+        // Every request blocks one thread in pread/pwrite, so queueDepth threads keep as many transfers in flight
+        class ThreadPoolFileIO : public PosixFileIO
+        {
+            public:
+                explicit ThreadPoolFileIO(const unsigned int& queueDepth) : PosixFileIO{queueDepth}, pool{queueDepth}
+                {
+
+                }
+
+                ioBackend backend() const override
+                {
+                    return ioBackend::THREAD_POOL;
+                }
+
+            protected:
+                void transfer(FileRequest* request) override
+                {
+                    pool.submit([this, request]()
+                    {
+                        while(request->transferred < request->size)
+                        {
+                            const auto size = std::min(request->size - request->transferred, maxTransferSize);
+                            const auto offset = static_cast<off_t>(request->transferred);
+                            const auto result = request->write ? ::pwrite(request->descriptor, request->data + request->transferred, size, offset)
+                                                               : ::pread(request->descriptor, request->data + request->transferred, size, offset);
+                            if(result < 0)
+                            {
+                                if(errno == EINTR)
+                                {
+                                    continue;
+                                }
+
+                                request->error = errno;
+                                break;
+                            }
+
+                            if(result == 0)
+                            {
+                                break;
+                            }
+
+                            request->transferred += static_cast<std::size_t>(result);
+                        }
+
+                        complete(request);
+                    });
+                }
+
+            private:
+                utils::threading::ThreadPool pool;
+        };
+
+#if defined(IMAGELOADER_IO_URING)
+        // Bounds how long the completion thread stays in the kernel before it looks at the stop flags again
+        constexpr std::chrono::milliseconds completionWaitTimeout{100};
+
+        int ioUringSetup(const unsigned int& entries, io_uring_params& parameters)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, &parameters));
+        }
+
+        int ioUringEnter(const int& ring, const unsigned int& submitCount, const unsigned int& minComplete, const unsigned int& flags)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, ring, submitCount, minComplete, flags, nullptr, 0));
+        }
+
+        // Blocks until a completion arrives or the timeout passes, the latter fails with ETIME
+        int ioUringWait(const int& ring, const std::chrono::milliseconds& timeout)
+        {
+            __kernel_timespec time{};
+            time.tv_sec = static_cast<long long>(timeout.count()/1000);
+            time.tv_nsec = static_cast<long long>(timeout.count()%1000)*1000000;
+
+            io_uring_getevents_arg argument{};
+            argument.ts = reinterpret_cast<std::uint64_t>(&time);
+            return static_cast<int>(syscall(__NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                            &argument, sizeof(argument)));
+        }
+
+        // A single ring, driven through the raw system calls so liburing is not needed. Submitters share the submission
+        // queue under a mutex, one thread waits for completions and resubmits the rest of short transfers.
+        class IoUringFileIO : public PosixFileIO
+        {
+            public:
+                // nullptr if the kernel does not support io_uring or does not allow it, e.g. inside containers
+                static std::unique_ptr<IoUringFileIO> create(const unsigned int& queueDepth)
+                {
+                    std::unique_ptr<IoUringFileIO> io{new IoUringFileIO{queueDepth}};
+                    if(!io->setUp())
+                    {
+                        return nullptr;
+                    }
+
+                    io->completionThread = std::thread{[io = io.get()]() { io->reap(); }};
+                    return io;
+                }
+
+                ~IoUringFileIO() override
+                {
+                    if(completionThread.joinable())
+                    {
+                        // A no-op without a request stops the completion thread once everything before it is reaped. A ring
+                        // that cannot take it any more is only polled, the thread sees the flags after its current wait.
+                        stopping.store(true, std::memory_order_relaxed);
+                        if(!submit(nullptr))
+                        {
+                            failed.store(true, std::memory_order_release);
+                        }
+                        completionThread.join();
+                    }
+
+                    if(submissionEntries != nullptr)
+                    {
+                        munmap(submissionEntries, submissionEntriesSize);
+                    }
+                    if(completionRing != nullptr && completionRing != submissionRing)
+                    {
+                        munmap(completionRing, completionRingSize);
+                    }
+                    if(submissionRing != nullptr)
+                    {
+                        munmap(submissionRing, submissionRingSize);
+                    }
+                    if(ring >= 0)
+                    {
+                        ::close(ring);
+                    }
+                }
+
+                ioBackend backend() const override
+                {
+                    return ioBackend::IO_URING;
+                }
+
+            protected:
+                void transfer(FileRequest* request) override
+                {
+                    if(!submit(request))
+                    {
+                        complete(request);
+                    }
+                }
+
+            private:
+                explicit IoUringFileIO(const unsigned int& queueDepth) : PosixFileIO{queueDepth}
+                {
+
+                }
+
+                bool setUp()
+                {
+                    // One entry more than requests in flight leaves room for the final no-op
+                    io_uring_params parameters{};
+                    ring = ioUringSetup(queueDepth() + 1, parameters);
+                    if(ring < 0)
+                    {
+                        return false;
+                    }
+
+                    // Waits for completions need a timeout, otherwise a ring refusing the final no-op blocks destruction
+                    if((parameters.features & IORING_FEAT_EXT_ARG) == 0)
+                    {
+                        return false;
+                    }
+
+                    submissionRingSize = parameters.sq_off.array + parameters.sq_entries*sizeof(unsigned int);
+                    completionRingSize = parameters.cq_off.cqes + parameters.cq_entries*sizeof(io_uring_cqe);
+                    const auto singleMapping = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                    if(singleMapping)
+                    {
+                        submissionRingSize = completionRingSize = std::max(submissionRingSize, completionRingSize);
+                    }
+
+                    submissionRing = map(submissionRingSize, IORING_OFF_SQ_RING);
+                    if(submissionRing == nullptr)
+                    {
+                        return false;
+                    }
+
+                    completionRing = singleMapping ? submissionRing : map(completionRingSize, IORING_OFF_CQ_RING);
+                    submissionEntriesSize = parameters.sq_entries*sizeof(io_uring_sqe);
+                    submissionEntries = map(submissionEntriesSize, IORING_OFF_SQES);
+                    if(completionRing == nullptr || submissionEntries == nullptr)
+                    {
+                        return false;
+                    }
+
+                    const auto submissionBase = static_cast<std::uint8_t*>(submissionRing);
+                    submissionHead = reinterpret_cast<unsigned int*>(submissionBase + parameters.sq_off.head);
+                    submissionTail = reinterpret_cast<unsigned int*>(submissionBase + parameters.sq_off.tail);
+                    submissionMask = *reinterpret_cast<unsigned int*>(submissionBase + parameters.sq_off.ring_mask);
+                    submissionArray = reinterpret_cast<unsigned int*>(submissionBase + parameters.sq_off.array);
+
+                    const auto completionBase = static_cast<std::uint8_t*>(completionRing);
+                    completionHead = reinterpret_cast<unsigned int*>(completionBase + parameters.cq_off.head);
+                    completionTail = reinterpret_cast<unsigned int*>(completionBase + parameters.cq_off.tail);
+                    completionMask = *reinterpret_cast<unsigned int*>(completionBase + parameters.cq_off.ring_mask);
+                    completions = reinterpret_cast<io_uring_cqe*>(completionBase + parameters.cq_off.cqes);
+                    return true;
+                }
+
+                void* map(const std::size_t& size, const off_t& offset)
+                {
+                    auto address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, offset);
+                    return address == MAP_FAILED ? nullptr : address;
+                }
+
+                // Queues the next part of the request, nullptr queues the no-op ending the completion thread.
+                // At most queueDepth requests are in flight, so the submission queue is never full. Returns false with
+                // the errno in request->error if the kernel did not take the entry, the caller completes the request then.
+                bool submit(FileRequest* request)
+                {
+                    std::lock_guard<std::mutex> lock{submissionMutex};
+                    if(failed.load(std::memory_order_acquire))
+                    {
+                        return reject(request, ECANCELED);
+                    }
+
+                    const auto tail = *submissionTail;
+                    const auto index = tail & submissionMask;
+                    auto& entry = static_cast<io_uring_sqe*>(submissionEntries)[index];
+                    std::memset(&entry, 0, sizeof(entry));
+
+                    if(request == nullptr)
+                    {
+                        entry.opcode = IORING_OP_NOP;
+                    }
+                    else
+                    {
+                        request->vector.iov_base = request->data + request->transferred;
+                        request->vector.iov_len = std::min(request->size - request->transferred, maxTransferSize);
+                        entry.opcode = request->write ? IORING_OP_WRITEV : IORING_OP_READV;
+                        entry.fd = request->descriptor;
+                        entry.addr = reinterpret_cast<std::uint64_t>(&request->vector);
+                        entry.len = 1;
+                        entry.off = request->transferred;
+                        entry.user_data = reinterpret_cast<std::uint64_t>(request);
+                    }
+
+                    submissionArray[index] = index;
+                    __atomic_store_n(submissionTail, tail + 1, __ATOMIC_RELEASE);
+
+                    auto submitted = ioUringEnter(ring, 1, 0, 0);
+                    while(submitted < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY))
+                    {
+                        std::this_thread::yield();
+                        submitted = ioUringEnter(ring, 1, 0, 0);
+                    }
+
+                    const auto error = submitted < 0 ? errno : EIO;
+                    if(submitted > 0 || __atomic_load_n(submissionHead, __ATOMIC_ACQUIRE) != tail)
+                    {
+                        return true;
+                    }
+
+                    // The entry is withdrawn, otherwise a later call would submit it after its request was completed
+                    __atomic_store_n(submissionTail, tail, __ATOMIC_RELEASE);
+                    return reject(request, error);
+                }
+
+                static bool reject(FileRequest* request, const int& error)
+                {
+                    if(request != nullptr)
+                    {
+                        request->error = error;
+                    }
+
+                    return false;
+                }
+
+                void reap()
+                {
+                    while(true)
+                    {
+                        const auto head = *completionHead;
+                        if(head == __atomic_load_n(completionTail, __ATOMIC_ACQUIRE))
+                        {
+                            if(failed.load(std::memory_order_acquire))
+                            {
+                                // Completions of requests still in flight are picked up without waiting in the kernel
+                                if(stopping.load(std::memory_order_relaxed))
+                                {
+                                    return;
+                                }
+
+                                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                            }
+                            else if(ioUringWait(ring, completionWaitTimeout) < 0 && errno != ETIME && errno != EINTR &&
+                                    errno != EAGAIN && errno != EBUSY)
+                            {
+                                // The ring is unusable, later submissions fail right away instead of hanging
+                                failed.store(true, std::memory_order_release);
+                            }
+                            continue;
+                        }
+
+                        const auto& entry = completions[head & completionMask];
+                        auto request = reinterpret_cast<FileRequest*>(entry.user_data);
+                        const auto result = entry.res;
+                        __atomic_store_n(completionHead, head + 1, __ATOMIC_RELEASE);
+
+                        if(request == nullptr)
+                        {
+                            return;
+                        }
+
+                        if((result == -EINTR || result == -EAGAIN) && submit(request))
+                        {
+                            continue;
+                        }
+
+                        if(result < 0)
+                        {
+                            if(request->error == 0)
+                            {
+                                request->error = -result;
+                            }
+                        }
+                        else
+                        {
+                            request->transferred += static_cast<std::size_t>(result);
+                            if(result > 0 && request->transferred < request->size && submit(request))
+                            {
+                                continue;
+                            }
+                        }
+
+                        complete(request);
+                    }
+                }
+
+            private:
+                int ring{-1};
+                void* submissionRing{nullptr};
+                void* completionRing{nullptr};
+                void* submissionEntries{nullptr};
+                std::size_t submissionRingSize{0};
+                std::size_t completionRingSize{0};
+                std::size_t submissionEntriesSize{0};
+
+                std::mutex submissionMutex;
+                unsigned int* submissionHead{nullptr};
+                unsigned int* submissionTail{nullptr};
+                unsigned int submissionMask{0};
+                unsigned int* submissionArray{nullptr};
+
+                // Only touched by the completion thread
+                unsigned int* completionHead{nullptr};
+                unsigned int* completionTail{nullptr};
+                unsigned int completionMask{0};
+                io_uring_cqe* completions{nullptr};
+
+                std::atomic<bool> failed{false};
+                std::atomic<bool> stopping{false};
+                std::thread completionThread;
+        };
+#endif
+    } // namespace
+
+    std::unique_ptr<AsyncFileIO> AsyncFileIO::create(const ioBackend& backend, const unsigned int& queueDepth)
+    {
+        const auto depth = std::clamp(queueDepth, 1u, maxQueueDepth);
+
+        if(ioBackend::IO_URING == backend)
+        {
+#if defined(IMAGELOADER_IO_URING)
+            if(auto io = IoUringFileIO::create(depth))
+            {
+                return io;
+            }
+#endif
+            return std::make_unique<ThreadPoolFileIO>(depth);
+        }
+
+        if(ioBackend::THREAD_POOL == backend)
+        {
+            return std::make_unique<ThreadPoolFileIO>(depth);
+        }
+
+        return nullptr;
+    }
+#endif
+} // namespace imageloader
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+
+#include "ErrorCodes.hpp"
+#include "tgaImage/TGAImageLoad.hpp"
+
+namespace imageloader
+{
+    // Contents of a file read by AsyncFileIO, size is less than the file size if the file shrank while it was read
+    struct FileContents
+    {
+        std::unique_ptr<std::uint8_t[]> data;
+        std::size_t size{0};
+    };
+
+    using ReadCompletion = std::function<void(std::variant<FileContents, ErrorCodes> contents)>;
+    using WriteCompletion = std::function<void(std::optional<ErrorCodes> result)>;
+
+    // Whole-file reads and writes running in the background, up to queueDepth of them at once. Submitting blocks while
+    // the queue is full. Completions are called from a thread of the backend and should return quickly.
+    class AsyncFileIO
+    {
+        public:
+            // nullptr for ioBackend::BLOCKING and on systems without a POSIX backend. IO_URING falls back to
+            // THREAD_POOL if the library was built without io_uring or the kernel refuses to set up a ring.
+            static std::unique_ptr<AsyncFileIO> create(const ioBackend& backend, const unsigned int& queueDepth);
+
+            virtual ~AsyncFileIO() = default;
+
+            virtual ioBackend backend() const = 0;
+            virtual unsigned int queueDepth() const = 0;
+
+            // Opens the file and submits a read of all of it. If the file cannot be opened the error is returned and
+            // completion is never called.
+            virtual std::optional<ErrorCodes> readFile(const std::string& filePath, ReadCompletion completion) = 0;
+            // Creates or truncates the file and submits a write of data, which has to stay valid until completion is called
+            virtual std::optional<ErrorCodes> writeFile(const std::string& filePath, const std::uint8_t* data, const std::size_t& size,
+                                                        WriteCompletion completion) = 0;
+    };
+} // namespace imageloader
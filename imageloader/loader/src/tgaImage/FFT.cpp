@@ -0,0 +1,1052 @@
+#include "tgaImage/FFT.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "ProcessingPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define IMAGELOADER_FFT_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace imageloader
+{
+    namespace
+    {
+        using Complex = std::complex<float>;
+
+        constexpr double pi = 3.14159265358979323846;
+        // Columns transformed together, the values of one row of a block fill a cache line
+        constexpr int columnBlock = 8;
+
+        // exp(-2*pi*i*numerator/denominator)
+        Complex rootOfUnity(const std::int64_t& numerator, const std::int64_t& denominator)
+        {
+            const auto angle = -2.0*pi*static_cast<double>(numerator % denominator)/static_cast<double>(denominator);
+            return {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+        }
+
+        // Plain product, std::complex checks for infinities and NaNs through a library call unless fast math is enabled
+        Complex product(const Complex& a, const Complex& b)
+        {
+            return {a.real()*b.real() - a.imag()*b.imag(), a.real()*b.imag() + a.imag()*b.real()};
+        }
+
+        // a*(-i)
+        Complex rotateClockwise(const Complex& a)
+        {
+            return {a.imag(), -a.real()};
+        }
+
+        // Radix 4 stages first, they need the fewest operations per element
+        std::vector<int> factorize(int size)
+        {
+            std::vector<int> radices;
+            while(size % 4 == 0)
+            {
+                radices.push_back(4);
+                size /= 4;
+            }
+
+            if(size % 2 == 0)
+            {
+                radices.push_back(2);
+                size /= 2;
+            }
+
+            for(auto factor = 3; size > 1; factor += 2)
+            {
+                if(factor*factor > size)
+                {
+                    radices.push_back(size);
+                    break;
+                }
+
+                while(size % factor == 0)
+                {
+                    radices.push_back(factor);
+                    size /= factor;
+                }
+            }
+
+            return radices;
+        }
+
+        // Stage of a decimation in frequency Stockham transform. For every group g and offset q < stride the radix
+        // elements x[q + stride*(g + k*groups)] are combined into y[q + stride*(radix*g + j)], j < radix.
+        struct Stage
+        {
+            int radix{0};
+            int groups{0};
+            int stride{0};
+            // (radix - 1)*groups twiddles, element (j - 1)*groups + g multiplies output j of group g
+            std::size_t twiddleOffset{0};
+            // radix roots of unity of the radix, used by the generic butterfly
+            std::size_t rootOffset{0};
+        };
+
+        void radix4Scalar(const Stage& stage, const Complex* twiddles, const Complex* x, Complex* y, const int& firstGroup)
+        {
+            const auto groups = stage.groups;
+            const auto stride = stage.stride;
+
+            for(auto group = firstGroup; group < groups; ++group)
+            {
+                const auto w1 = twiddles[group];
+                const auto w2 = twiddles[groups + group];
+                const auto w3 = twiddles[2*groups + group];
+
+                for(auto q = 0; q < stride; ++q)
+                {
+                    const auto a0 = x[q + stride*group];
+                    const auto a1 = x[q + stride*(group + groups)];
+                    const auto a2 = x[q + stride*(group + 2*groups)];
+                    const auto a3 = x[q + stride*(group + 3*groups)];
+
+                    const auto sum02 = a0 + a2;
+                    const auto difference02 = a0 - a2;
+                    const auto sum13 = a1 + a3;
+                    const auto difference13 = rotateClockwise(a1 - a3);
+
+                    const auto output = y + q + stride*4*group;
+                    output[0] = sum02 + sum13;
+                    output[stride] = product(difference02 + difference13, w1);
+                    output[2*stride] = product(sum02 - sum13, w2);
+                    output[3*stride] = product(difference02 - difference13, w3);
+                }
+            }
+        }
+
+        void radix2Scalar(const Stage& stage, const Complex* twiddles, const Complex* x, Complex* y, const int& firstGroup)
+        {
+            const auto groups = stage.groups;
+            const auto stride = stage.stride;
+
+            for(auto group = firstGroup; group < groups; ++group)
+            {
+                const auto w = twiddles[group];
+                for(auto q = 0; q < stride; ++q)
+                {
+                    const auto a0 = x[q + stride*group];
+                    const auto a1 = x[q + stride*(group + groups)];
+
+                    const auto output = y + q + stride*2*group;
+                    output[0] = a0 + a1;
+                    output[stride] = product(a0 - a1, w);
+                }
+            }
+        }
+
+        void radix3Stage(const Stage& stage, const Complex* twiddles, const Complex* x, Complex* y)
+        {
+            const auto groups = stage.groups;
+            const auto stride = stage.stride;
+            // sin(2*pi/3)
+            constexpr auto sine = 0.866025403784438647f;
+
+            for(auto group = 0; group < groups; ++group)
+            {
+                const auto w1 = twiddles[group];
+                const auto w2 = twiddles[groups + group];
+
+                for(auto q = 0; q < stride; ++q)
+                {
+                    const auto a0 = x[q + stride*group];
+                    const auto a1 = x[q + stride*(group + groups)];
+                    const auto a2 = x[q + stride*(group + 2*groups)];
+
+                    const auto sum = a1 + a2;
+                    const auto real = a0 - 0.5f*sum;
+                    const auto imaginary = rotateClockwise(sine*(a1 - a2));
+
+                    const auto output = y + q + stride*3*group;
+                    output[0] = a0 + sum;
+                    output[stride] = product(real + imaginary, w1);
+                    output[2*stride] = product(real - imaginary, w2);
+                }
+            }
+        }
+
+        void radix5Stage(const Stage& stage, const Complex* twiddles, const Complex* x, Complex* y)
+        {
+            const auto groups = stage.groups;
+            const auto stride = stage.stride;
+            // cos and sin of 2*pi/5 and 4*pi/5
+            constexpr auto cosine1 = 0.309016994374947424f;
+            constexpr auto cosine2 = -0.809016994374947424f;
+            constexpr auto sine1 = 0.951056516295153572f;
+            constexpr auto sine2 = 0.587785252292473129f;
+
+            for(auto group = 0; group < groups; ++group)
+            {
+                const auto w1 = twiddles[group];
+                const auto w2 = twiddles[groups + group];
+                const auto w3 = twiddles[2*groups + group];
+                const auto w4 = twiddles[3*groups + group];
+
+                for(auto q = 0; q < stride; ++q)
+                {
+                    const auto a0 = x[q + stride*group];
+                    const auto a1 = x[q + stride*(group + groups)];
+                    const auto a2 = x[q + stride*(group + 2*groups)];
+                    const auto a3 = x[q + stride*(group + 3*groups)];
+                    const auto a4 = x[q + stride*(group + 4*groups)];
+
+                    const auto sum14 = a1 + a4;
+                    const auto sum23 = a2 + a3;
+                    const auto difference14 = a1 - a4;
+                    const auto difference23 = a2 - a3;
+
+                    const auto real1 = a0 + cosine1*sum14 + cosine2*sum23;
+                    const auto real2 = a0 + cosine2*sum14 + cosine1*sum23;
+                    const auto imaginary1 = rotateClockwise(sine1*difference14 + sine2*difference23);
+                    const auto imaginary2 = rotateClockwise(sine2*difference14 - sine1*difference23);
+
+                    const auto output = y + q + stride*5*group;
+                    output[0] = a0 + sum14 + sum23;
+                    output[stride] = product(real1 + imaginary1, w1);
+                    output[2*stride] = product(real2 + imaginary2, w2);
+                    output[3*stride] = product(real2 - imaginary2, w3);
+                    output[4*stride] = product(real1 - imaginary1, w4);
+                }
+            }
+        }
+
+        // Direct DFT of the radix elements, used for prime factors above 5
+        void genericStage(const Stage& stage, const Complex* twiddles, const Complex* roots, const Complex* x, Complex* y)
+        {
+            const auto radix = stage.radix;
+            const auto groups = stage.groups;
+            const auto stride = stage.stride;
+
+            std::vector<Complex> elements(radix);
+            for(auto group = 0; group < groups; ++group)
+            {
+                for(auto q = 0; q < stride; ++q)
+                {
+                    for(auto k = 0; k < radix; ++k)
+                    {
+                        elements[k] = x[q + stride*(group + k*groups)];
+                    }
+
+                    const auto output = y + q + stride*radix*group;
+                    for(auto j = 0; j < radix; ++j)
+                    {
+                        auto sum = elements[0];
+                        for(auto k = 1; k < radix; ++k)
+                        {
+                            sum += product(elements[k], roots[(j*k) % radix]);
+                        }
+                        output[j*stride] = j == 0 ? sum : product(sum, twiddles[(j - 1)*groups + group]);
+                    }
+                }
+            }
+        }
+
+    #if defined(IMAGELOADER_FFT_SSE2)
+        // Registers hold two complex numbers as (re, im, re, im)
+        __m128 loadPair(const Complex* values)
+        {
+            return _mm_loadu_ps(reinterpret_cast<const float*>(values));
+        }
+
+        void storePair(Complex* values, const __m128& pair)
+        {
+            _mm_storeu_ps(reinterpret_cast<float*>(values), pair);
+        }
+
+        // Both halves hold value
+        __m128 broadcast(const Complex& value)
+        {
+            return _mm_castpd_ps(_mm_load1_pd(reinterpret_cast<const double*>(&value)));
+        }
+
+        __m128 multiply(const __m128& a, const __m128& w)
+        {
+            const auto real = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 0, 0));
+            const auto imaginary = _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 1, 1));
+            const auto swapped = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+            const auto negateReal = _mm_castsi128_ps(_mm_set_epi32(0, INT32_MIN, 0, INT32_MIN));
+            return _mm_add_ps(_mm_mul_ps(a, real), _mm_xor_ps(_mm_mul_ps(swapped, imaginary), negateReal));
+        }
+
+        // a*(-i) = (im, -re)
+        __m128 rotateClockwisePair(const __m128& a)
+        {
+            const auto negateImaginary = _mm_castsi128_ps(_mm_set_epi32(INT32_MIN, 0, INT32_MIN, 0));
+            return _mm_xor_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), negateImaginary);
+        }
+
+        // Butterflies of two groups or two offsets at once, outputs replace the inputs
+        void butterfly4(__m128& a0, __m128& a1, __m128& a2, __m128& a3, const __m128& w1, const __m128& w2, const __m128& w3)
+        {
+            const auto sum02 = _mm_add_ps(a0, a2);
+            const auto difference02 = _mm_sub_ps(a0, a2);
+            const auto sum13 = _mm_add_ps(a1, a3);
+            const auto difference13 = rotateClockwisePair(_mm_sub_ps(a1, a3));
+
+            a0 = _mm_add_ps(sum02, sum13);
+            a1 = multiply(_mm_add_ps(difference02, difference13), w1);
+            a2 = multiply(_mm_sub_ps(sum02, sum13), w2);
+            a3 = multiply(_mm_sub_ps(difference02, difference13), w3);
+        }
+
+        void radix4SSE2(const Stage& stage, const Complex* twiddles, const Complex* x, Complex* y)
+        {
+            const auto groups = stage.groups;
+            const auto stride = stage.stride;
+
+            // Strides are powers of two, with stride >= 2 offsets q and q + 1 share the twiddles
+            if(stride >= 2)
+            {
+                for(auto group = 0; group < groups; ++group)
+                {
+                    const auto w1 = broadcast(twiddles[group]);
+                    const auto w2 = broadcast(twiddles[groups + group]);
+                    const auto w3 = broadcast(twiddles[2*groups + group]);
+
+                    const auto output = y + stride*4*group;
+                    for(auto q = 0; q < stride; q += 2)
+                    {
+                        auto a0 = loadPair(x + q + stride*group);
+                        auto a1 = loadPair(x + q + stride*(group + groups));
+                        auto a2 = loadPair(x + q + stride*(group + 2*groups));
+                        auto a3 = loadPair(x + q + stride*(group + 3*groups));
+                        butterfly4(a0, a1, a2, a3, w1, w2, w3);
+
+                        storePair(output + q, a0);
+                        storePair(output + q + stride, a1);
+                        storePair(output + q + 2*stride, a2);
+                        storePair(output + q + 3*stride, a3);
+                    }
+                }
+                return;
+            }
+
+            // First stage, groups g and g + 1 are adjacent in the input and get their outputs four elements apart
+            auto group = 0;
+            for(; group + 1 < groups; group += 2)
+            {
+                auto a0 = loadPair(x + group);
+                auto a1 = loadPair(x + group + groups);
+                auto a2 = loadPair(x + group + 2*groups);
+                auto a3 = loadPair(x + group + 3*groups);
+                butterfly4(a0, a1, a2, a3, loadPair(twiddles + group), loadPair(twiddles + groups + group), loadPair(twiddles + 2*groups + group));
+
+                const __m128 outputs[4] = {a0, a1, a2, a3};
+                for(auto j = 0; j < 4; ++j)
+                {
+                    _mm_storel_pi(reinterpret_cast<__m64*>(y + 4*group + j), outputs[j]);
+                    _mm_storeh_pi(reinterpret_cast<__m64*>(y + 4*group + 4 + j), outputs[j]);
+                }
+            }
+
+            radix4Scalar(stage, twiddles, x, y, group);
+        }
+
+        void radix2SSE2(const Stage& stage, const Complex* twiddles, const Complex* x, Complex* y)
+        {
+            const auto groups = stage.groups;
+            const auto stride = stage.stride;
+
+            if(stride >= 2)
+            {
+                for(auto group = 0; group < groups; ++group)
+                {
+                    const auto w = broadcast(twiddles[group]);
+                    const auto output = y + stride*2*group;
+                    for(auto q = 0; q < stride; q += 2)
+                    {
+                        const auto a0 = loadPair(x + q + stride*group);
+                        const auto a1 = loadPair(x + q + stride*(group + groups));
+                        storePair(output + q, _mm_add_ps(a0, a1));
+                        storePair(output + q + stride, multiply(_mm_sub_ps(a0, a1), w));
+                    }
+                }
+                return;
+            }
+
+            radix2Scalar(stage, twiddles, x, y, 0);
+        }
+    #endif
+
+        void conjugate(Complex* values, const std::size_t& count)
+        {
+            for(std::size_t index = 0; index < count; ++index)
+            {
+                values[index] = std::conj(values[index]);
+            }
+        }
+
+        // Mixed radix Stockham autosort transform. Every stage reads one buffer and writes the other, the result
+        // comes out in natural order without a bit reversal pass.
+        class ComplexTransform
+        {
+            public:
+                explicit ComplexTransform(const int& size) : length{size}
+                {
+                    auto remaining = size;
+                    auto stride = 1;
+                    for(const auto radix : factorize(size))
+                    {
+                        const auto groups = remaining/radix;
+                        stages.push_back(Stage{radix, groups, stride, twiddles.size(), roots.size()});
+
+                        for(auto j = 1; j < radix; ++j)
+                        {
+                            for(auto group = 0; group < groups; ++group)
+                            {
+                                twiddles.push_back(rootOfUnity(static_cast<std::int64_t>(j)*group, remaining));
+                            }
+                        }
+
+                        for(auto k = 0; k < radix; ++k)
+                        {
+                            roots.push_back(rootOfUnity(k, radix));
+                        }
+
+                        remaining = groups;
+                        stride *= radix;
+                    }
+                }
+
+                int size() const
+                {
+                    return length;
+                }
+
+                // Unnormalized transform in place, scratch holds size() values
+                void forward(Complex* data, Complex* scratch) const
+                {
+                    auto source = data;
+                    auto destination = scratch;
+                    for(const auto& stage : stages)
+                    {
+                        runStage(stage, source, destination);
+                        std::swap(source, destination);
+                    }
+
+                    if(source != data)
+                    {
+                        std::memcpy(data, source, static_cast<std::size_t>(length)*sizeof(Complex));
+                    }
+                }
+
+                // Unnormalized inverse, conj(forward(conj(data)))
+                void inverse(Complex* data, Complex* scratch) const
+                {
+                    conjugate(data, static_cast<std::size_t>(length));
+                    forward(data, scratch);
+                    conjugate(data, static_cast<std::size_t>(length));
+                }
+
+            private:
+                void runStage(const Stage& stage, const Complex* x, Complex* y) const
+                {
+                    const auto stageTwiddles = twiddles.data() + stage.twiddleOffset;
+                    switch(stage.radix)
+                    {
+                        case 4:
+                        #if defined(IMAGELOADER_FFT_SSE2)
+                            radix4SSE2(stage, stageTwiddles, x, y);
+                        #else
+                            radix4Scalar(stage, stageTwiddles, x, y, 0);
+                        #endif
+                            break;
+                        case 2:
+                        #if defined(IMAGELOADER_FFT_SSE2)
+                            radix2SSE2(stage, stageTwiddles, x, y);
+                        #else
+                            radix2Scalar(stage, stageTwiddles, x, y, 0);
+                        #endif
+                            break;
+                        case 3:
+                            radix3Stage(stage, stageTwiddles, x, y);
+                            break;
+                        case 5:
+                            radix5Stage(stage, stageTwiddles, x, y);
+                            break;
+                        default:
+                            genericStage(stage, stageTwiddles, roots.data() + stage.rootOffset, x, y);
+                            break;
+                    }
+                }
+
+            private:
+                int length{0};
+                std::vector<Stage> stages;
+                std::vector<Complex> twiddles;
+                std::vector<Complex> roots;
+        };
+
+        // Real input of even size is transformed as a complex sequence of half the size, with even samples as real and
+        // odd samples as imaginary parts, whose spectrum is then split into the spectra of both. Odd sizes go through
+        // a complex transform of full size.
+        class RealTransform
+        {
+            public:
+                explicit RealTransform(const int& size) :
+                                length{size},
+                                complex{size % 2 == 0 ? size/2 : size}
+                {
+                    if(size % 2 == 0)
+                    {
+                        for(auto k = 0; k <= size/2; ++k)
+                        {
+                            splitTwiddles.push_back(rootOfUnity(k, size));
+                        }
+                    }
+                }
+
+                std::size_t scratchSize() const
+                {
+                    return static_cast<std::size_t>(length % 2 == 0 ? length/2 : 2*length);
+                }
+
+                // output receives size/2 + 1 bins
+                void forward(const float* input, Complex* output, Complex* scratch) const
+                {
+                    if(length % 2 != 0)
+                    {
+                        for(auto index = 0; index < length; ++index)
+                        {
+                            scratch[index] = Complex{input[index], 0.0f};
+                        }
+                        complex.forward(scratch, scratch + length);
+                        std::copy(scratch, scratch + length/2 + 1, output);
+                        return;
+                    }
+
+                    const auto half = length/2;
+                    for(auto index = 0; index < half; ++index)
+                    {
+                        output[index] = Complex{input[2*index], input[2*index + 1]};
+                    }
+                    complex.forward(output, scratch);
+
+                    const auto first = output[0];
+                    output[0] = Complex{first.real() + first.imag(), 0.0f};
+                    output[half] = Complex{first.real() - first.imag(), 0.0f};
+
+                    // Bins k and half - k are computed from the same pair of values
+                    for(auto k = 1; k <= half - k; ++k)
+                    {
+                        const auto value = output[k];
+                        const auto mirrored = std::conj(output[half - k]);
+                        const auto even = (value + mirrored)*0.5f;
+                        const auto odd = (value - mirrored)*Complex{0.0f, -0.5f};
+
+                        output[k] = even + product(splitTwiddles[k], odd);
+                        output[half - k] = std::conj(even) + product(splitTwiddles[half - k], std::conj(odd));
+                    }
+                }
+
+                // Unnormalized inverse of forward multiplied by scale, input is overwritten
+                void inverse(Complex* input, float* output, Complex* scratch, const float& scale) const
+                {
+                    if(length % 2 != 0)
+                    {
+                        for(auto k = 0; k <= length/2; ++k)
+                        {
+                            scratch[k] = input[k];
+                            if(k > 0)
+                            {
+                                scratch[length - k] = std::conj(input[k]);
+                            }
+                        }
+                        complex.inverse(scratch, scratch + length);
+                        for(auto index = 0; index < length; ++index)
+                        {
+                            output[index] = scratch[index].real()*scale;
+                        }
+                        return;
+                    }
+
+                    const auto half = length/2;
+                    for(auto k = 0; k <= half - k; ++k)
+                    {
+                        const auto value = input[k];
+                        const auto mirrored = input[half - k];
+
+                        // i*z is -(z*(-i))
+                        input[k] = value + std::conj(mirrored) - rotateClockwise(product(value - std::conj(mirrored), std::conj(splitTwiddles[k])));
+                        if(k > 0 && k != half - k)
+                        {
+                            input[half - k] = mirrored + std::conj(value) -
+                                              rotateClockwise(product(mirrored - std::conj(value), std::conj(splitTwiddles[half - k])));
+                        }
+                    }
+
+                    complex.inverse(input, scratch);
+                    for(auto index = 0; index < half; ++index)
+                    {
+                        output[2*index] = input[index].real()*scale;
+                        output[2*index + 1] = input[index].imag()*scale;
+                    }
+                }
+
+            private:
+                int length{0};
+                ComplexTransform complex;
+                // exp(-2*pi*i*k/size) for k in [0, size/2]
+                std::vector<Complex> splitTwiddles;
+        };
+
+        std::optional<ErrorCodes> validateChannel(const ConstImageView& image, const int& channel)
+        {
+            if(image.bytesPerPixel() < 1 || image.bytesPerPixel() > 4 || image.bytesPerPixel() == 2)
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
+            if(image.empty() || channel < 0 || channel >= image.bytesPerPixel())
+            {
+                return ErrorCodes::IndexOutOfRange;
+            }
+
+            return std::nullopt;
+        }
+
+        std::optional<ErrorCodes> validatePair(const ConstImageView& input, const ConstImageView& output)
+        {
+            auto result = validateChannel(input, 0);
+            if(result.has_value())
+            {
+                return result;
+            }
+
+            if(input.bytesPerPixel() != output.bytesPerPixel())
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
+            if(input.width() != output.width() || input.height() != output.height())
+            {
+                return ErrorCodes::IndexOutOfRange;
+            }
+
+            return std::nullopt;
+        }
+
+        // Channel of image as samples of a width x height grid, multiplied by the separable window if one is given
+        std::vector<float> channelSamples(const ConstImageView& image, const int& channel, const std::vector<float>& columnWindow = {},
+                                          const std::vector<float>& rowWindow = {})
+        {
+            const auto width = image.width();
+            std::vector<float> samples(static_cast<std::size_t>(width)*image.height());
+            for(auto y = 0; y < image.height(); ++y)
+            {
+                const auto row = image.row(y) + channel;
+                const auto destination = samples.data() + static_cast<std::size_t>(y)*width;
+                for(auto x = 0; x < width; ++x)
+                {
+                    destination[x] = row[x*image.bytesPerPixel()];
+                }
+
+                if(!columnWindow.empty())
+                {
+                    for(auto x = 0; x < width; ++x)
+                    {
+                        destination[x] *= columnWindow[x]*rowWindow[y];
+                    }
+                }
+            }
+
+            return samples;
+        }
+
+        // Region of a width wide grid starting at (left, top) rounded into a channel of image
+        void storeSamples(const float* samples, const int& width, const int& left, const int& top, const ImageView& image, const int& channel)
+        {
+            for(auto y = 0; y < image.height(); ++y)
+            {
+                const auto source = samples + static_cast<std::size_t>(y + top)*width + left;
+                const auto row = image.row(y) + channel;
+                for(auto x = 0; x < image.width(); ++x)
+                {
+                    row[x*image.bytesPerPixel()] = static_cast<std::uint8_t>(std::clamp(std::lround(source[x]), 0L, 255L));
+                }
+            }
+        }
+
+        std::vector<float> hannWindow(const int& size)
+        {
+            std::vector<float> window(size, 1.0f);
+            for(auto index = 0; size > 1 && index < size; ++index)
+            {
+                window[index] = static_cast<float>(0.5 - 0.5*std::cos(2.0*pi*index/(size - 1)));
+            }
+
+            return window;
+        }
+
+        // Peak position between the neighbours left and right of a parabola through the three values
+        float peakOffset(const float& left, const float& center, const float& right)
+        {
+            const auto curvature = left - 2.0f*center + right;
+            return curvature < 0.0f ? std::clamp(0.5f*(left - right)/curvature, -0.5f, 0.5f) : 0.0f;
+        }
+    } // namespace
+
+    class FourierPlanImpl
+    {
+        public:
+            FourierPlanImpl(const int& width, const int& height) :
+                            width{width},
+                            height{height},
+                            rows{width},
+                            columns{height}
+            {
+
+            }
+
+            int spectrumWidth() const
+            {
+                return width/2 + 1;
+            }
+
+            // Blocks of adjacent columns are gathered into contiguous buffers, transformed and scattered back
+            void transformColumns(Complex* spectrum, const bool& inverse) const
+            {
+                const auto binCount = spectrumWidth();
+                forEachBand(binCount, static_cast<std::size_t>(height), columnBlock, [&](const int& firstColumn, const int& columnCount)
+                {
+                    std::vector<Complex> block(static_cast<std::size_t>(columnBlock)*height);
+                    std::vector<Complex> scratch(height);
+
+                    const auto lastColumn = firstColumn + columnCount;
+                    for(auto left = firstColumn; left < lastColumn; left += columnBlock)
+                    {
+                        const auto blockColumns = std::min(columnBlock, lastColumn - left);
+                        for(auto y = 0; y < height; ++y)
+                        {
+                            const auto row = spectrum + static_cast<std::size_t>(y)*binCount + left;
+                            for(auto column = 0; column < blockColumns; ++column)
+                            {
+                                block[static_cast<std::size_t>(column)*height + y] = row[column];
+                            }
+                        }
+
+                        for(auto column = 0; column < blockColumns; ++column)
+                        {
+                            const auto values = block.data() + static_cast<std::size_t>(column)*height;
+                            if(inverse)
+                            {
+                                columns.inverse(values, scratch.data());
+                            }
+                            else
+                            {
+                                columns.forward(values, scratch.data());
+                            }
+                        }
+
+                        for(auto y = 0; y < height; ++y)
+                        {
+                            const auto row = spectrum + static_cast<std::size_t>(y)*binCount + left;
+                            for(auto column = 0; column < blockColumns; ++column)
+                            {
+                                row[column] = block[static_cast<std::size_t>(column)*height + y];
+                            }
+                        }
+                    }
+                });
+            }
+
+            int width{0};
+            int height{0};
+            RealTransform rows;
+            ComplexTransform columns;
+    };
+
+    FourierPlan::FourierPlan(const int& width, const int& height) : d_ptr{new FourierPlanImpl{width, height}}
+    {
+
+    }
+
+    FourierPlan::~FourierPlan() = default;
+
+    int FourierPlan::width() const
+    {
+        return d_ptr->width;
+    }
+
+    int FourierPlan::height() const
+    {
+        return d_ptr->height;
+    }
+
+    int FourierPlan::spectrumWidth() const
+    {
+        return d_ptr->spectrumWidth();
+    }
+
+    void FourierPlan::forward(const float* input, const std::size_t& rowStride, std::complex<float>* spectrum) const
+    {
+        const auto binCount = static_cast<std::size_t>(spectrumWidth());
+        forEachBand(d_ptr->height, static_cast<std::size_t>(d_ptr->width), 1, [&](const int& firstRow, const int& rowCount)
+        {
+            std::vector<Complex> scratch(d_ptr->rows.scratchSize());
+            for(auto y = firstRow; y < firstRow + rowCount; ++y)
+            {
+                d_ptr->rows.forward(input + y*rowStride, spectrum + y*binCount, scratch.data());
+            }
+        });
+
+        d_ptr->transformColumns(spectrum, false);
+    }
+
+    void FourierPlan::inverse(std::complex<float>* spectrum, float* output, const std::size_t& rowStride) const
+    {
+        d_ptr->transformColumns(spectrum, true);
+
+        const auto binCount = static_cast<std::size_t>(spectrumWidth());
+        const auto scale = 1.0f/(static_cast<float>(d_ptr->width)*static_cast<float>(d_ptr->height));
+        forEachBand(d_ptr->height, static_cast<std::size_t>(d_ptr->width), 1, [&](const int& firstRow, const int& rowCount)
+        {
+            std::vector<Complex> scratch(d_ptr->rows.scratchSize());
+            for(auto y = firstRow; y < firstRow + rowCount; ++y)
+            {
+                d_ptr->rows.inverse(spectrum + y*binCount, output + y*rowStride, scratch.data(), scale);
+            }
+        });
+    }
+
+    std::shared_ptr<const FourierPlan> fourierPlan(const int& width, const int& height)
+    {
+        if(width <= 0 || height <= 0)
+        {
+            return nullptr;
+        }
+
+        static std::mutex mutex;
+        static std::map<std::pair<int, int>, std::shared_ptr<const FourierPlan>> plans;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        auto& plan = plans[{width, height}];
+        if(!plan)
+        {
+            plan = std::make_shared<const FourierPlan>(width, height);
+        }
+
+        return plan;
+    }
+
+    int fastTransformSize(const int& size)
+    {
+        for(auto candidate = std::max(size, 1);; ++candidate)
+        {
+            auto remaining = candidate;
+            for(const auto factor : {2, 3, 5})
+            {
+                while(remaining % factor == 0)
+                {
+                    remaining /= factor;
+                }
+            }
+
+            if(remaining == 1)
+            {
+                return candidate;
+            }
+        }
+    }
+
+    std::variant<Spectrum, ErrorCodes> channelSpectrum(const ConstImageView& image, const int& channel)
+    {
+        auto result = validateChannel(image, channel);
+        if(result.has_value())
+        {
+            return result.value();
+        }
+
+        const auto plan = fourierPlan(image.width(), image.height());
+        const auto samples = channelSamples(image, channel);
+
+        Spectrum spectrum{image.width(), image.height(), {}};
+        spectrum.bins.resize(static_cast<std::size_t>(plan->spectrumWidth())*image.height());
+        plan->forward(samples.data(), static_cast<std::size_t>(image.width()), spectrum.bins.data());
+
+        return spectrum;
+    }
+
+    std::optional<ErrorCodes> spectrumToChannel(Spectrum& spectrum, const ImageView& image, const int& channel)
+    {
+        auto result = validateChannel(image, channel);
+        if(result.has_value())
+        {
+            return result;
+        }
+
+        if(image.width() != spectrum.width || image.height() != spectrum.height ||
+           spectrum.bins.size() != static_cast<std::size_t>(spectrum.width/2 + 1)*spectrum.height)
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        std::vector<float> samples(static_cast<std::size_t>(spectrum.width)*spectrum.height);
+        fourierPlan(spectrum.width, spectrum.height)->inverse(spectrum.bins.data(), samples.data(), static_cast<std::size_t>(spectrum.width));
+        storeSamples(samples.data(), spectrum.width, 0, 0, image, channel);
+
+        return std::nullopt;
+    }
+
+    void applyResponse(Spectrum& spectrum, const FrequencyResponse& response)
+    {
+        const auto binCount = spectrum.width/2 + 1;
+        for(auto row = 0; row < spectrum.height; ++row)
+        {
+            const auto frequency = row < (spectrum.height + 1)/2 ? row : row - spectrum.height;
+            const auto v = static_cast<float>(frequency)/static_cast<float>(spectrum.height);
+
+            const auto bins = spectrum.bins.data() + static_cast<std::size_t>(row)*binCount;
+            for(auto column = 0; column < binCount; ++column)
+            {
+                bins[column] *= response(static_cast<float>(column)/static_cast<float>(spectrum.width), v);
+            }
+        }
+    }
+
+    std::optional<ErrorCodes> filterFrequencies(const ConstImageView& input, const ImageView& output, const FrequencyResponse& response)
+    {
+        auto result = validatePair(input, output);
+        if(result.has_value())
+        {
+            return result;
+        }
+
+        for(auto channel = 0; channel < input.bytesPerPixel(); ++channel)
+        {
+            auto spectrum = std::get<Spectrum>(channelSpectrum(input, channel));
+            applyResponse(spectrum, response);
+            result = spectrumToChannel(spectrum, output, channel);
+        }
+
+        return result;
+    }
+
+    std::optional<ErrorCodes> convolveFFT(const ConstImageView& input, const ImageView& output, const std::vector<float>& kernel,
+                                          const int& kernelWidth, const int& kernelHeight)
+    {
+        auto result = validatePair(input, output);
+        if(result.has_value())
+        {
+            return result;
+        }
+
+        if(kernelWidth <= 0 || kernelHeight <= 0 || kernelWidth % 2 == 0 || kernelHeight % 2 == 0 ||
+           kernel.size() != static_cast<std::size_t>(kernelWidth)*kernelHeight)
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        // The image is padded with its edge pixels, so the cyclic convolution only wraps around inside the padding
+        const auto radiusX = kernelWidth/2;
+        const auto radiusY = kernelHeight/2;
+        const auto width = fastTransformSize(input.width() + 2*radiusX);
+        const auto height = fastTransformSize(input.height() + 2*radiusY);
+        const auto plan = fourierPlan(width, height);
+        const auto gridSize = static_cast<std::size_t>(width)*height;
+        const auto binCount = static_cast<std::size_t>(plan->spectrumWidth())*height;
+
+        // Tap (i, j) is placed at (-i, -j), which turns the cyclic convolution into the correlation described above
+        std::vector<float> grid(gridSize, 0.0f);
+        for(auto j = -radiusY; j <= radiusY; ++j)
+        {
+            for(auto i = -radiusX; i <= radiusX; ++i)
+            {
+                const auto x = (width - i) % width;
+                const auto y = (height - j) % height;
+                grid[static_cast<std::size_t>(y)*width + x] += kernel[static_cast<std::size_t>(j + radiusY)*kernelWidth + i + radiusX];
+            }
+        }
+
+        std::vector<Complex> kernelSpectrum(binCount);
+        plan->forward(grid.data(), static_cast<std::size_t>(width), kernelSpectrum.data());
+
+        std::vector<Complex> spectrum(binCount);
+        for(auto channel = 0; channel < input.bytesPerPixel(); ++channel)
+        {
+            for(auto y = 0; y < height; ++y)
+            {
+                const auto row = input.row(std::clamp(y - radiusY, 0, input.height() - 1)) + channel;
+                const auto destination = grid.data() + static_cast<std::size_t>(y)*width;
+                for(auto x = 0; x < width; ++x)
+                {
+                    destination[x] = row[std::clamp(x - radiusX, 0, input.width() - 1)*input.bytesPerPixel()];
+                }
+            }
+
+            plan->forward(grid.data(), static_cast<std::size_t>(width), spectrum.data());
+            for(std::size_t bin = 0; bin < binCount; ++bin)
+            {
+                spectrum[bin] = product(spectrum[bin], kernelSpectrum[bin]);
+            }
+            plan->inverse(spectrum.data(), grid.data(), static_cast<std::size_t>(width));
+
+            storeSamples(grid.data(), width, radiusX, radiusY, output, channel);
+        }
+
+        return std::nullopt;
+    }
+
+    std::variant<Translation, ErrorCodes> phaseCorrelation(const ConstImageView& reference, const ConstImageView& moved, const int& channel)
+    {
+        auto result = validatePair(reference, moved);
+        if(!result.has_value())
+        {
+            result = validateChannel(reference, channel);
+        }
+
+        if(result.has_value())
+        {
+            return result.value();
+        }
+
+        const auto width = reference.width();
+        const auto height = reference.height();
+        const auto plan = fourierPlan(width, height);
+        const auto binCount = static_cast<std::size_t>(plan->spectrumWidth())*height;
+
+        const auto columnWindow = hannWindow(width);
+        const auto rowWindow = hannWindow(height);
+
+        std::vector<Complex> referenceSpectrum(binCount);
+        std::vector<Complex> movedSpectrum(binCount);
+        plan->forward(channelSamples(reference, channel, columnWindow, rowWindow).data(), static_cast<std::size_t>(width), referenceSpectrum.data());
+        plan->forward(channelSamples(moved, channel, columnWindow, rowWindow).data(), static_cast<std::size_t>(width), movedSpectrum.data());
+
+        // Normalized cross power spectrum, its inverse is a peak at the shift
+        for(std::size_t bin = 0; bin < binCount; ++bin)
+        {
+            const auto crossPower = product(movedSpectrum[bin], std::conj(referenceSpectrum[bin]));
+            const auto magnitude = std::abs(crossPower);
+            movedSpectrum[bin] = magnitude > 1e-20f ? crossPower/magnitude : Complex{};
+        }
+
+        std::vector<float> correlation(static_cast<std::size_t>(width)*height);
+        plan->inverse(movedSpectrum.data(), correlation.data(), static_cast<std::size_t>(width));
+
+        const auto peak = static_cast<int>(std::max_element(correlation.begin(), correlation.end()) - correlation.begin());
+        const auto peakX = peak % width;
+        const auto peakY = peak/width;
+        const auto at = [&](const int& x, const int& y)
+        {
+            return correlation[static_cast<std::size_t>((y + height) % height)*width + (x + width) % width];
+        };
+
+        Translation translation;
+        translation.response = at(peakX, peakY);
+        translation.x = static_cast<float>(peakX > width/2 ? peakX - width : peakX) +
+                        peakOffset(at(peakX - 1, peakY), translation.response, at(peakX + 1, peakY));
+        translation.y = static_cast<float>(peakY > height/2 ? peakY - height : peakY) +
+                        peakOffset(at(peakX, peakY - 1), translation.response, at(peakX, peakY + 1));
+
+        return translation;
+    }
+} // namespace imageloader
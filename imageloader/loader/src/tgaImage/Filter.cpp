@@ -0,0 +1,557 @@
+#include "tgaImage/Filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "ProcessingPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define IMAGELOADER_FILTER_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace imageloader
+{
+    namespace
+    {
+        // Weights are fixed point numbers with this many fractional bits, pixel times weight sums fit into 32 bits
+        constexpr int weightBits = 14;
+        constexpr std::int32_t weightRounding = 1<<(weightBits - 1);
+        // Horizontally filtered rows of a tile are kept in a buffer of about this size, so the vertical pass reads them from L2
+        constexpr std::size_t tileBytes = 256*1024;
+        constexpr double pi = 3.14159265358979323846;
+
+        // Taps of a separable filter along one axis. Output coordinate i is the weighted sum of the input coordinates
+        // [starts[i], starts[i] + counts[i]) with weights[i*taps ...].
+        struct Coefficients
+        {
+            int taps{0};
+            // Convolutions use the same taps for all coordinates away from the edges, output i of [uniformFirst, uniformLast)
+            // sums the inputs [i - taps/2, i + taps/2] with the weights of uniformFirst
+            int uniformFirst{0};
+            int uniformLast{0};
+            std::vector<int> starts;
+            std::vector<int> counts;
+            std::vector<std::int16_t> weights;
+
+            const std::int16_t* weightsOf(const int& index) const
+            {
+                return weights.data() + static_cast<std::size_t>(index)*taps;
+            }
+        };
+
+        // The weights of a row are scaled to sum to exactly 1<<weightBits, so flat areas stay flat through both passes.
+        // Rounding the running sum instead of every weight keeps each weight within 1 of its exact value.
+        void toFixedPoint(const double* weights, const int& count, std::int16_t* fixedWeights)
+        {
+            const auto total = std::accumulate(weights, weights + count, 0.0);
+            if(total == 0.0)
+            {
+                std::fill(fixedWeights, fixedWeights + count, std::int16_t{0});
+                return;
+            }
+
+            auto sum = 0.0;
+            long previous = 0;
+            for(auto tap = 0; tap < count; ++tap)
+            {
+                sum += weights[tap];
+                const auto rounded = tap + 1 == count ? long{1<<weightBits} : std::lround(sum/total*(1<<weightBits));
+                fixedWeights[tap] = static_cast<std::int16_t>(rounded - previous);
+                previous = rounded;
+            }
+        }
+
+        // Convolution with a symmetric kernel of 2*radius + 1 taps. Taps outside the image are added to the edge pixel.
+        Coefficients convolutionCoefficients(const int& size, const std::vector<double>& kernel)
+        {
+            const auto radius = static_cast<int>(kernel.size()/2);
+
+            Coefficients coefficients;
+            coefficients.taps = static_cast<int>(kernel.size());
+            coefficients.uniformFirst = std::min(radius, size);
+            coefficients.uniformLast = std::max(size - radius, coefficients.uniformFirst);
+            coefficients.starts.resize(size);
+            coefficients.counts.resize(size);
+            coefficients.weights.assign(static_cast<std::size_t>(size)*coefficients.taps, 0);
+
+            std::vector<double> folded(kernel.size());
+            for(auto index = 0; index < size; ++index)
+            {
+                const auto first = std::max(0, index - radius);
+                const auto last = std::min(size - 1, index + radius);
+
+                std::fill(folded.begin(), folded.end(), 0.0);
+                for(auto tap = -radius; tap <= radius; ++tap)
+                {
+                    const auto position = std::clamp(index + tap, first, last);
+                    folded[position - first] += kernel[tap + radius];
+                }
+
+                coefficients.starts[index] = first;
+                coefficients.counts[index] = last - first + 1;
+                toFixedPoint(folded.data(), last - first + 1, coefficients.weights.data() + static_cast<std::size_t>(index)*coefficients.taps);
+            }
+
+            return coefficients;
+        }
+
+        double filterWeight(const resampleFilter& filter, double position)
+        {
+            position = std::fabs(position);
+            switch(filter)
+            {
+                case resampleFilter::BILINEAR:
+                    return position < 1.0 ? 1.0 - position : 0.0;
+                case resampleFilter::BICUBIC:
+                {
+                    // Keys cubic with a = -0.5
+                    constexpr auto a = -0.5;
+                    if(position < 1.0)
+                    {
+                        return ((a + 2.0)*position - (a + 3.0))*position*position + 1.0;
+                    }
+                    if(position < 2.0)
+                    {
+                        return (((position - 5.0)*position + 8.0)*position - 4.0)*a;
+                    }
+                    return 0.0;
+                }
+                case resampleFilter::LANCZOS:
+                {
+                    if(position == 0.0)
+                    {
+                        return 1.0;
+                    }
+                    if(position >= 3.0)
+                    {
+                        return 0.0;
+                    }
+                    const auto x = pi*position;
+                    return 3.0*std::sin(x)*std::sin(x/3.0)/(x*x);
+                }
+            }
+
+            return 0.0;
+        }
+
+        double filterSupport(const resampleFilter& filter)
+        {
+            switch(filter)
+            {
+                case resampleFilter::BILINEAR:
+                    return 1.0;
+                case resampleFilter::BICUBIC:
+                    return 2.0;
+                default:
+                    return 3.0;
+            }
+        }
+
+        Coefficients resampleCoefficients(const int& inputSize, const int& outputSize, const resampleFilter& filter)
+        {
+            const auto scale = static_cast<double>(inputSize)/outputSize;
+            const auto filterScale = std::max(scale, 1.0);
+            const auto support = filterSupport(filter)*filterScale;
+
+            Coefficients coefficients;
+            coefficients.taps = static_cast<int>(std::ceil(support))*2 + 1;
+            coefficients.starts.resize(outputSize);
+            coefficients.counts.resize(outputSize);
+            coefficients.weights.assign(static_cast<std::size_t>(outputSize)*coefficients.taps, 0);
+
+            std::vector<double> weights(coefficients.taps);
+            for(auto index = 0; index < outputSize; ++index)
+            {
+                const auto center = (index + 0.5)*scale;
+                const auto first = std::max(static_cast<int>(center - support + 0.5), 0);
+                const auto last = std::min(static_cast<int>(center + support + 0.5), inputSize);
+                const auto count = std::min(last - first, coefficients.taps);
+
+                for(auto tap = 0; tap < count; ++tap)
+                {
+                    weights[tap] = filterWeight(filter, (first + tap - center + 0.5)/filterScale);
+                }
+
+                coefficients.starts[index] = first;
+                coefficients.counts[index] = count;
+                toFixedPoint(weights.data(), count, coefficients.weights.data() + static_cast<std::size_t>(index)*coefficients.taps);
+            }
+
+            return coefficients;
+        }
+
+        std::uint8_t clampToByte(const std::int32_t& sum)
+        {
+            return static_cast<std::uint8_t>(std::clamp((sum + weightRounding)>>weightBits, 0, 255));
+        }
+
+        template<int bytesPerPixel>
+        void horizontalPassScalar(const std::uint8_t* input, std::uint8_t* output, const int& first, const int& last,
+                                  const Coefficients& coefficients)
+        {
+            for(auto x = first; x < last; ++x)
+            {
+                const auto weights = coefficients.weightsOf(x);
+                const auto count = coefficients.counts[x];
+                const auto source = input + static_cast<std::size_t>(coefficients.starts[x])*bytesPerPixel;
+                for(auto channel = 0; channel < bytesPerPixel; ++channel)
+                {
+                    std::int32_t sum = 0;
+                    for(auto tap = 0; tap < count; ++tap)
+                    {
+                        sum += source[tap*bytesPerPixel + channel]*weights[tap];
+                    }
+                    output[x*bytesPerPixel + channel] = clampToByte(sum);
+                }
+            }
+        }
+
+        // Sums the weighted input rows into rowSize output bytes, starting at byte first
+        void verticalPassScalar(const std::uint8_t* const* rows, const std::int16_t* weights, const int& count,
+                                std::uint8_t* output, const std::size_t& first, const std::size_t& rowSize)
+        {
+            for(auto byte = first; byte < rowSize; ++byte)
+            {
+                std::int32_t sum = 0;
+                for(auto tap = 0; tap < count; ++tap)
+                {
+                    sum += rows[tap][byte]*weights[tap];
+                }
+                output[byte] = clampToByte(sum);
+            }
+        }
+
+    #if defined(IMAGELOADER_FILTER_SSE2)
+        __m128i pairedWeights(const std::int16_t& first, const std::int16_t& second)
+        {
+            return _mm_set1_epi32(static_cast<std::int32_t>((static_cast<std::uint32_t>(static_cast<std::uint16_t>(second))<<16) |
+                                                            static_cast<std::uint16_t>(first)));
+        }
+
+        __m128i roundAndShift(const __m128i& sum)
+        {
+            return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(weightRounding)), weightBits);
+        }
+
+        // Two taps of all four channels are multiplied and added with a single madd
+        void horizontalPassSSE2(const std::uint8_t* input, std::uint8_t* output, const int& first, const int& last,
+                                const Coefficients& coefficients)
+        {
+            const auto zero = _mm_setzero_si128();
+
+            for(auto x = first; x < last; ++x)
+            {
+                const auto weights = coefficients.weightsOf(x);
+                const auto count = coefficients.counts[x];
+                const auto source = input + static_cast<std::size_t>(coefficients.starts[x])*4;
+
+                auto sum = _mm_setzero_si128();
+                auto tap = 0;
+                for(; tap + 1 < count; tap += 2)
+                {
+                    const auto pixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + tap*4)), zero);
+                    const auto interleaved = _mm_unpacklo_epi16(pixels, _mm_srli_si128(pixels, 8));
+                    sum = _mm_add_epi32(sum, _mm_madd_epi16(interleaved, pairedWeights(weights[tap], weights[tap + 1])));
+                }
+
+                if(tap < count)
+                {
+                    std::int32_t value{};
+                    std::memcpy(&value, source + tap*4, sizeof(value));
+                    const auto pixel = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+                    sum = _mm_add_epi32(sum, _mm_madd_epi16(pixel, pairedWeights(weights[tap], 0)));
+                }
+
+                const auto packed = _mm_packus_epi16(_mm_packs_epi32(roundAndShift(sum), zero), zero);
+                const auto result = _mm_cvtsi128_si32(packed);
+                std::memcpy(output + x*4, &result, sizeof(result));
+            }
+        }
+
+        // Sixteen bytes of a row per step, pairs of input rows share a madd
+        void verticalPassSSE2(const std::uint8_t* const* rows, const std::int16_t* weights, const int& count,
+                              std::uint8_t* output, const std::size_t& rowSize)
+        {
+            const auto zero = _mm_setzero_si128();
+
+            std::size_t byte = 0;
+            for(; byte + 16 <= rowSize; byte += 16)
+            {
+                __m128i sums[4] = {zero, zero, zero, zero};
+                for(auto tap = 0; tap < count; tap += 2)
+                {
+                    const auto hasPair = tap + 1 < count;
+                    const auto upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[tap] + byte));
+                    const auto lower = hasPair ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[tap + 1] + byte)) : zero;
+                    const auto weight = pairedWeights(weights[tap], hasPair ? weights[tap + 1] : 0);
+
+                    const auto upperLow = _mm_unpacklo_epi8(upper, zero);
+                    const auto upperHigh = _mm_unpackhi_epi8(upper, zero);
+                    const auto lowerLow = _mm_unpacklo_epi8(lower, zero);
+                    const auto lowerHigh = _mm_unpackhi_epi8(lower, zero);
+
+                    sums[0] = _mm_add_epi32(sums[0], _mm_madd_epi16(_mm_unpacklo_epi16(upperLow, lowerLow), weight));
+                    sums[1] = _mm_add_epi32(sums[1], _mm_madd_epi16(_mm_unpackhi_epi16(upperLow, lowerLow), weight));
+                    sums[2] = _mm_add_epi32(sums[2], _mm_madd_epi16(_mm_unpacklo_epi16(upperHigh, lowerHigh), weight));
+                    sums[3] = _mm_add_epi32(sums[3], _mm_madd_epi16(_mm_unpackhi_epi16(upperHigh, lowerHigh), weight));
+                }
+
+                const auto low = _mm_packs_epi32(roundAndShift(sums[0]), roundAndShift(sums[1]));
+                const auto high = _mm_packs_epi32(roundAndShift(sums[2]), roundAndShift(sums[3]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + byte), _mm_packus_epi16(low, high));
+            }
+
+            verticalPassScalar(rows, weights, count, output, byte, rowSize);
+        }
+    #endif
+
+        void verticalPass(const std::uint8_t* const* rows, const std::int16_t* weights, const int& count,
+                          std::uint8_t* output, const std::size_t& rowSize)
+        {
+        #if defined(IMAGELOADER_FILTER_SSE2)
+            verticalPassSSE2(rows, weights, count, output, rowSize);
+        #else
+            verticalPassScalar(rows, weights, count, output, 0, rowSize);
+        #endif
+        }
+
+        using PixelKernel = void (*)(const std::uint8_t*, std::uint8_t*, const int&, const int&, const Coefficients&);
+
+        PixelKernel selectPixelKernel(const int& bytesPerPixel)
+        {
+            switch(bytesPerPixel)
+            {
+                case 1:
+                    return horizontalPassScalar<1>;
+                case 3:
+                    return horizontalPassScalar<3>;
+                default:
+                #if defined(IMAGELOADER_FILTER_SSE2)
+                    return horizontalPassSSE2;
+                #else
+                    return horizontalPassScalar<4>;
+                #endif
+            }
+        }
+
+        // Outputs with individual taps are computed pixel by pixel. In the uniform part a tap is the same input row shifted
+        // by whole pixels for every output, so it runs through the vertical kernel on byte offsets of the row.
+        void horizontalPass(const std::uint8_t* input, std::uint8_t* output, const int& width, const int& bytesPerPixel,
+                            const Coefficients& coefficients, const PixelKernel& kernel, std::vector<const std::uint8_t*>& shiftedRows)
+        {
+            if(coefficients.uniformFirst >= coefficients.uniformLast)
+            {
+                kernel(input, output, 0, width, coefficients);
+                return;
+            }
+
+            kernel(input, output, 0, coefficients.uniformFirst, coefficients);
+
+            const auto first = static_cast<std::size_t>(coefficients.uniformFirst);
+            for(auto tap = 0; tap < coefficients.taps; ++tap)
+            {
+                shiftedRows[tap] = input + (first + tap - coefficients.taps/2)*bytesPerPixel;
+            }
+            verticalPass(shiftedRows.data(), coefficients.weightsOf(coefficients.uniformFirst), coefficients.taps,
+                         output + first*bytesPerPixel, static_cast<std::size_t>(coefficients.uniformLast - coefficients.uniformFirst)*bytesPerPixel);
+
+            kernel(input, output, coefficients.uniformLast, width, coefficients);
+        }
+
+        // Called with every finished output row
+        using RowCallback = std::function<void(const int& y, std::uint8_t* row)>;
+
+        // Output rows are split into bands processed on the worker pool. Every band is processed in tiles of rows:
+        // the input rows a tile needs are filtered horizontally into a buffer that stays in cache and is reused by
+        // the next tile, the vertical pass then reads them from there.
+        void separableFilter(const ConstImageView& input, const ImageView& output,
+                             const Coefficients& horizontal, const Coefficients& vertical, const RowCallback& finishRow)
+        {
+            const auto bytesPerPixel = output.bytesPerPixel();
+            const auto rowSize = output.rowSize();
+
+            forEachBand(output.height(), static_cast<std::size_t>(output.width())*vertical.taps, 1, [&](const int& firstRow, const int& rowCount)
+            {
+                std::vector<std::uint8_t> intermediate;
+                std::vector<const std::uint8_t*> rows(vertical.taps);
+                std::vector<const std::uint8_t*> shiftedRows(horizontal.taps);
+                const auto kernel = selectPixelKernel(bytesPerPixel);
+                // Input rows at the border of a tile are filtered horizontally for both neighbouring tiles, with wide rows
+                // a few taps high tiles keep that repeated work small even though the buffer outgrows the cache
+                const auto tileRows = static_cast<int>(std::max<std::size_t>(tileBytes/std::max<std::size_t>(rowSize, 1),
+                                                                             4*static_cast<std::size_t>(vertical.taps)));
+
+                const auto lastRow = firstRow + rowCount;
+                for(auto tileFirst = firstRow; tileFirst < lastRow; tileFirst += tileRows)
+                {
+                    const auto tileLast = std::min(tileFirst + tileRows, lastRow);
+
+                    auto inputFirst = vertical.starts[tileFirst];
+                    auto inputLast = inputFirst;
+                    for(auto y = tileFirst; y < tileLast; ++y)
+                    {
+                        inputFirst = std::min(inputFirst, vertical.starts[y]);
+                        inputLast = std::max(inputLast, vertical.starts[y] + vertical.counts[y]);
+                    }
+
+                    intermediate.resize(static_cast<std::size_t>(inputLast - inputFirst)*rowSize);
+                    for(auto y = inputFirst; y < inputLast; ++y)
+                    {
+                        horizontalPass(input.row(y), intermediate.data() + (y - inputFirst)*rowSize, output.width(), bytesPerPixel,
+                                       horizontal, kernel, shiftedRows);
+                    }
+
+                    for(auto y = tileFirst; y < tileLast; ++y)
+                    {
+                        for(auto tap = 0; tap < vertical.counts[y]; ++tap)
+                        {
+                            rows[tap] = intermediate.data() + static_cast<std::size_t>(vertical.starts[y] + tap - inputFirst)*rowSize;
+                        }
+
+                        verticalPass(rows.data(), vertical.weightsOf(y), vertical.counts[y], output.row(y), rowSize);
+                        if(finishRow)
+                        {
+                            finishRow(y, output.row(y));
+                        }
+                    }
+                }
+            });
+        }
+
+        std::optional<ErrorCodes> validate(const ConstImageView& input, const ImageView& output, const bool& sameSize)
+        {
+            const auto bytesPerPixel = input.bytesPerPixel();
+            if(bytesPerPixel != output.bytesPerPixel() || bytesPerPixel < 1 || bytesPerPixel > 4 || bytesPerPixel == 2)
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
+            if(input.empty() || output.empty() || (sameSize && (input.width() != output.width() || input.height() != output.height())))
+            {
+                return ErrorCodes::IndexOutOfRange;
+            }
+
+            return std::nullopt;
+        }
+
+        std::vector<double> gaussianKernel(const float& sigma)
+        {
+            const auto radius = std::max(1, static_cast<int>(std::ceil(3.0*sigma)));
+            std::vector<double> kernel(2*radius + 1);
+
+            auto total = 0.0;
+            for(auto tap = -radius; tap <= radius; ++tap)
+            {
+                kernel[tap + radius] = std::exp(-(tap*tap)/(2.0*sigma*sigma));
+                total += kernel[tap + radius];
+            }
+
+            for(auto& weight : kernel)
+            {
+                weight /= total;
+            }
+
+            return kernel;
+        }
+
+        std::optional<ErrorCodes> convolve(const ConstImageView& input, const ImageView& output, const std::vector<double>& kernel,
+                                           const RowCallback& finishRow)
+        {
+            auto result = validate(input, output, true);
+            if(result.has_value())
+            {
+                return result;
+            }
+
+            separableFilter(input, output, convolutionCoefficients(input.width(), kernel),
+                            convolutionCoefficients(input.height(), kernel), finishRow);
+
+            return std::nullopt;
+        }
+    } // namespace
+
+    std::optional<ErrorCodes> gaussianBlur(const ConstImageView& input, const ImageView& output, const float& sigma)
+    {
+        if(!(sigma > 0.0f))
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        return convolve(input, output, gaussianKernel(sigma), nullptr);
+    }
+
+    std::optional<ErrorCodes> boxBlur(const ConstImageView& input, const ImageView& output, const int& radius)
+    {
+        if(radius < 0)
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        return convolve(input, output, std::vector<double>(2*radius + 1, 1.0/(2*radius + 1)), nullptr);
+    }
+
+    std::optional<ErrorCodes> sharpen(const ConstImageView& input, const ImageView& output, const float& amount, const float& sigma)
+    {
+        if(!(sigma > 0.0f) || amount < 0.0f)
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        // The blurred row is turned into the sharpened one while it is still in cache, amount has 8 fractional bits
+        const auto scaledAmount = static_cast<std::int32_t>(std::lround(amount*256.0f));
+        const auto rowSize = input.rowSize();
+
+        return convolve(input, output, gaussianKernel(sigma), [&](const int& y, std::uint8_t* row)
+        {
+            const auto original = input.row(y);
+            for(std::size_t byte = 0; byte < rowSize; ++byte)
+            {
+                const auto difference = static_cast<std::int32_t>(original[byte]) - row[byte];
+                row[byte] = static_cast<std::uint8_t>(std::clamp(original[byte] + ((difference*scaledAmount + 128)>>8), 0, 255));
+            }
+        });
+    }
+
+    std::optional<ErrorCodes> resize(const ConstImageView& input, const ImageView& output, const resampleFilter& filter)
+    {
+        auto result = validate(input, output, false);
+        if(result.has_value())
+        {
+            return result;
+        }
+
+        separableFilter(input, output, resampleCoefficients(input.width(), output.width(), filter),
+                        resampleCoefficients(input.height(), output.height(), filter), nullptr);
+
+        return std::nullopt;
+    }
+
+    std::variant<TGAImage, ErrorCodes> resizeImage(const TGAImage& image, const int& width, const int& height, const resampleFilter& filter)
+    {
+        if(width <= 0 || height <= 0 || width > UINT16_MAX || height > UINT16_MAX)
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        const auto bytesPerPixel = image.bitsPerPixel();
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width)*height*bytesPerPixel);
+
+        auto result = resize(image.constView(), ImageView{pixels.data(), width, height, bytesPerPixel}, filter);
+        if(result.has_value())
+        {
+            return result.value();
+        }
+
+        auto header = image.getHeader();
+        header.width = static_cast<std::uint16_t>(width);
+        header.height = static_cast<std::uint16_t>(height);
+
+        return TGAImage{width, height, bytesPerPixel, header, std::move(pixels)};
+    }
+} // namespace imageloader
@@ -0,0 +1,304 @@
+#include "tgaImage/Geometry.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "Orientation.hpp"
+#include "ProcessingPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define IMAGELOADER_GEOMETRY_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace imageloader
+{
+    namespace
+    {
+        // Pixels per side of a tile, a tile of the source and of the destination fit the L1/L2 cache together
+        constexpr int tileSize = 64;
+
+        // Input pixel (x, y) is written to origin + x*rowStep + y*columnStep. Transposition and both quarter turns only
+        // differ in the signs of the steps and the corner the origin is in.
+        struct Placement
+        {
+            std::uint8_t* origin{nullptr};
+            std::ptrdiff_t rowStep{0};
+            std::ptrdiff_t columnStep{0};
+
+            std::uint8_t* at(const int& x, const int& y) const
+            {
+                return origin + x*rowStep + y*columnStep;
+            }
+        };
+
+        // A tile is transposed into a small buffer first. Buffer row x - left holds input column x from top to bottom,
+        // or from bottom to top if reversed, and is copied out with a single memcpy. Writing whole cache lines keeps
+        // power of two row strides, whose output rows share cache sets, from evicting partially written lines.
+        struct TileBuffer
+        {
+            std::uint8_t* data{nullptr};
+            std::size_t rowStride{0};
+            bool reversed{false};
+        };
+
+        template<int bytesPerPixel>
+        void transposeTileScalar(const ConstImageView& input, const TileBuffer& buffer,
+                                 const int& left, const int& top, const int& right, const int& bottom)
+        {
+            for(auto y = top; y < bottom; ++y)
+            {
+                auto source = input.pixel(left, y);
+                auto destination = buffer.data + (buffer.reversed ? bottom - 1 - y : y - top)*bytesPerPixel;
+                for(auto x = left; x < right; ++x, source += bytesPerPixel, destination += buffer.rowStride)
+                {
+                    std::memcpy(destination, source, bytesPerPixel);
+                }
+            }
+        }
+
+    #if defined(IMAGELOADER_GEOMETRY_SSE2)
+        // Blocks of 4x4 pixels are transposed in registers, every buffer row gets four pixels with a single store
+        void transposeTileSSE2(const ConstImageView& input, const TileBuffer& buffer,
+                               const int& left, const int& top, const int& right, const int& bottom)
+        {
+            const auto blockRight = left + (right - left)/4*4;
+            const auto blockBottom = top + (bottom - top)/4*4;
+
+            for(auto y = top; y < blockBottom; y += 4)
+            {
+                const auto offset = (buffer.reversed ? bottom - 4 - y : y - top)*4;
+                for(auto x = left; x < blockRight; x += 4)
+                {
+                    const auto row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.pixel(x, y)));
+                    const auto row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.pixel(x, y + 1)));
+                    const auto row2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.pixel(x, y + 2)));
+                    const auto row3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.pixel(x, y + 3)));
+
+                    const auto low01 = _mm_unpacklo_epi32(row0, row1);
+                    const auto low23 = _mm_unpacklo_epi32(row2, row3);
+                    const auto high01 = _mm_unpackhi_epi32(row0, row1);
+                    const auto high23 = _mm_unpackhi_epi32(row2, row3);
+
+                    const __m128i columns[4] = {_mm_unpacklo_epi64(low01, low23), _mm_unpackhi_epi64(low01, low23),
+                                                _mm_unpacklo_epi64(high01, high23), _mm_unpackhi_epi64(high01, high23)};
+
+                    auto destination = buffer.data + (x - left)*buffer.rowStride + offset;
+                    for(auto column = 0; column < 4; ++column, destination += buffer.rowStride)
+                    {
+                        const auto value = buffer.reversed ? _mm_shuffle_epi32(columns[column], _MM_SHUFFLE(0, 1, 2, 3)) : columns[column];
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), value);
+                    }
+                }
+            }
+
+            // Remaining columns of the 4 row blocks and the remaining rows
+            if(blockRight != right)
+            {
+                const TileBuffer edge{buffer.data + (blockRight - left)*buffer.rowStride, buffer.rowStride, buffer.reversed};
+                transposeTileScalar<4>(input, edge, blockRight, top, right, bottom);
+            }
+
+            // Reversed rows are placed relative to bottom, the others relative to the first row passed to the kernel
+            if(blockBottom != bottom)
+            {
+                const TileBuffer edge{buffer.data + (buffer.reversed ? 0 : (blockBottom - top)*4), buffer.rowStride, buffer.reversed};
+                transposeTileScalar<4>(input, edge, left, blockBottom, blockRight, bottom);
+            }
+        }
+    #endif
+
+        using TileKernel = void (*)(const ConstImageView&, const TileBuffer&, const int&, const int&, const int&, const int&);
+
+        TileKernel selectTileKernel(const int& bytesPerPixel)
+        {
+            switch(bytesPerPixel)
+            {
+                case 1:
+                    return transposeTileScalar<1>;
+                case 2:
+                    return transposeTileScalar<2>;
+                case 3:
+                    return transposeTileScalar<3>;
+                default:
+                #if defined(IMAGELOADER_GEOMETRY_SSE2)
+                    return transposeTileSSE2;
+                #else
+                    return transposeTileScalar<4>;
+                #endif
+            }
+        }
+
+        std::optional<ErrorCodes> validate(const ConstImageView& input, const ImageView& output, const bool& swapsDimensions)
+        {
+            if(input.bytesPerPixel() != output.bytesPerPixel() || input.bytesPerPixel() < 1 || input.bytesPerPixel() > 4)
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
+            const auto width = swapsDimensions ? input.height() : input.width();
+            const auto height = swapsDimensions ? input.width() : input.height();
+            if(output.width() != width || output.height() != height || input.empty() != output.empty())
+            {
+                return ErrorCodes::IndexOutOfRange;
+            }
+
+            return std::nullopt;
+        }
+
+        // Bands of tile rows of the input are independent, each of them fills its own columns of the output
+        void transposeTiles(const ConstImageView& input, const Placement& placement)
+        {
+            const auto kernel = selectTileKernel(input.bytesPerPixel());
+            const auto bytesPerPixel = input.bytesPerPixel();
+            const auto reversed = placement.columnStep < 0;
+
+            forEachBand(input.height(), input.width(), tileSize, [&](const int& firstRow, const int& rowCount)
+            {
+                std::vector<std::uint8_t> tile(static_cast<std::size_t>(tileSize)*tileSize*bytesPerPixel);
+                const TileBuffer buffer{tile.data(), static_cast<std::size_t>(tileSize)*bytesPerPixel, reversed};
+
+                const auto lastRow = firstRow + rowCount;
+                for(auto top = firstRow; top < lastRow; top += tileSize)
+                {
+                    const auto bottom = std::min(top + tileSize, lastRow);
+                    const auto segmentSize = static_cast<std::size_t>(bottom - top)*bytesPerPixel;
+                    for(auto left = 0; left < input.width(); left += tileSize)
+                    {
+                        const auto right = std::min(left + tileSize, input.width());
+                        kernel(input, buffer, left, top, right, bottom);
+
+                        for(auto x = left; x < right; ++x)
+                        {
+                            std::memcpy(placement.at(x, reversed ? bottom - 1 : top), tile.data() + (x - left)*buffer.rowStride, segmentSize);
+                        }
+                    }
+                }
+            });
+        }
+
+        void rotateHalfTurn(const ConstImageView& input, const ImageView& output)
+        {
+            const auto height = input.height();
+            const auto rowSize = input.rowSize();
+
+            if(input.data() != output.data())
+            {
+                forEachBand(height, input.width(), 1, [&](const int& firstRow, const int& rowCount)
+                {
+                    for(auto y = firstRow; y < firstRow + rowCount; ++y)
+                    {
+                        const auto destination = output.row(height - 1 - y);
+                        std::memcpy(destination, input.row(y), rowSize);
+                        reversePixels(destination, input.width(), input.bytesPerPixel());
+                    }
+                });
+                return;
+            }
+
+            // In place, the top half of the rows is swapped with the bottom half and both rows of a pair are reversed
+            const auto pairCount = height/2;
+            forEachBand(pairCount, 2*input.width(), 1, [&](const int& firstPair, const int& pairs)
+            {
+                std::vector<std::uint8_t> buffer(rowSize);
+                for(auto top = firstPair; top < firstPair + pairs; ++top)
+                {
+                    const auto upper = output.row(top);
+                    const auto lower = output.row(height - 1 - top);
+                    std::memcpy(buffer.data(), upper, rowSize);
+                    std::memcpy(upper, lower, rowSize);
+                    std::memcpy(lower, buffer.data(), rowSize);
+                    reversePixels(upper, input.width(), input.bytesPerPixel());
+                    reversePixels(lower, input.width(), input.bytesPerPixel());
+                }
+            });
+
+            if(height % 2 != 0)
+            {
+                reversePixels(output.row(pairCount), input.width(), input.bytesPerPixel());
+            }
+        }
+
+        template<typename Transform>
+        std::variant<TGAImage, ErrorCodes> transformedImage(const TGAImage& image, const bool& swapsDimensions, Transform&& transform)
+        {
+            const auto width = swapsDimensions ? image.height() : image.width();
+            const auto height = swapsDimensions ? image.width() : image.height();
+            const auto bytesPerPixel = image.bitsPerPixel();
+
+            std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width)*height*bytesPerPixel);
+            auto result = transform(image.constView(), ImageView{pixels.data(), width, height, bytesPerPixel});
+            if(result.has_value())
+            {
+                return result.value();
+            }
+
+            auto header = image.getHeader();
+            header.width = static_cast<std::uint16_t>(width);
+            header.height = static_cast<std::uint16_t>(height);
+
+            return TGAImage{width, height, bytesPerPixel, header, std::move(pixels)};
+        }
+    } // namespace
+
+    std::optional<ErrorCodes> transpose(const ConstImageView& input, const ImageView& output)
+    {
+        auto result = validate(input, output, true);
+        if(result.has_value() || input.empty())
+        {
+            return result;
+        }
+
+        const auto bytesPerPixel = static_cast<std::ptrdiff_t>(input.bytesPerPixel());
+        transposeTiles(input, Placement{output.data(), static_cast<std::ptrdiff_t>(output.rowStride()), bytesPerPixel});
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> rotate(const ConstImageView& input, const ImageView& output, const rotationAngle& angle)
+    {
+        auto result = validate(input, output, rotationAngle::DEGREES_180 != angle);
+        if(result.has_value() || input.empty())
+        {
+            return result;
+        }
+
+        const auto bytesPerPixel = static_cast<std::ptrdiff_t>(input.bytesPerPixel());
+        const auto outputStride = static_cast<std::ptrdiff_t>(output.rowStride());
+
+        switch(angle)
+        {
+            case rotationAngle::DEGREES_90:
+                // Input row y becomes output column height - 1 - y
+                transposeTiles(input, Placement{output.pixel(output.width() - 1, 0), outputStride, -bytesPerPixel});
+                break;
+            case rotationAngle::DEGREES_180:
+                rotateHalfTurn(input, output);
+                break;
+            case rotationAngle::DEGREES_270:
+                // Input column x becomes output row width - 1 - x
+                transposeTiles(input, Placement{output.row(output.height() - 1), -outputStride, bytesPerPixel});
+                break;
+        }
+
+        return std::nullopt;
+    }
+
+    std::variant<TGAImage, ErrorCodes> transposeImage(const TGAImage& image)
+    {
+        return transformedImage(image, true, [](const ConstImageView& input, const ImageView& output)
+        {
+            return transpose(input, output);
+        });
+    }
+
+    std::variant<TGAImage, ErrorCodes> rotateImage(const TGAImage& image, const rotationAngle& angle)
+    {
+        return transformedImage(image, rotationAngle::DEGREES_180 != angle, [&angle](const ConstImageView& input, const ImageView& output)
+        {
+            return rotate(input, output, angle);
+        });
+    }
+} // namespace imageloader
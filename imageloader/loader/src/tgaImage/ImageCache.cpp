@@ -0,0 +1,237 @@
+#include "tgaImage/ImageCache.hpp"
+
+#include <filesystem>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace imageloader
+{
+    namespace
+    {
+        using CachedImage = std::variant<std::shared_ptr<const TGAImage>, ErrorCodes>;
+
+        struct FileVersion
+        {
+            std::uintmax_t size{0};
+            std::filesystem::file_time_type modified;
+
+            bool operator==(const FileVersion& rhs) const
+            {
+                return size == rhs.size && modified == rhs.modified;
+            }
+        };
+
+        struct CacheEntry
+        {
+            FileVersion version;
+            // Ready once the decode finished, callers missing while it runs wait on the same future
+            std::shared_future<CachedImage> image;
+            bool decoded{false};
+            std::size_t bytes{0};
+            // Identifies the decode that created the entry, an entry replaced meanwhile is left alone by it
+            std::uint64_t generation{0};
+            std::list<std::string>::iterator recentlyUsed;
+        };
+    } // namespace
+
+    class ImageCacheImpl
+    {
+        public:
+            ImageCacheImpl(TGAImageLoader& loader, const std::size_t& byteBudget) :
+                        loader{loader},
+                        byteBudget{byteBudget}
+            {
+
+            }
+
+            CachedImage loadImage(const std::string_view& imagePath)
+            {
+                std::error_code error;
+                const auto path = std::filesystem::canonical(std::filesystem::path{imagePath}, error);
+                FileVersion version;
+                if(!error)
+                {
+                    version.size = std::filesystem::file_size(path, error);
+                }
+                if(!error)
+                {
+                    version.modified = std::filesystem::last_write_time(path, error);
+                }
+                if(error)
+                {
+                    return ErrorCodes::InvalidPath;
+                }
+
+                auto key = path.string();
+                std::promise<CachedImage> promise;
+                std::shared_future<CachedImage> cached;
+                std::uint64_t generation = 0;
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    auto entry = entries.find(key);
+                    if(entry != entries.end() && entry->second.version == version)
+                    {
+                        ++usage.hits;
+                        if(entry->second.decoded)
+                        {
+                            recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed, entry->second.recentlyUsed);
+                        }
+
+                        cached = entry->second.image;
+                    }
+                    else
+                    {
+                        // The file changed or was never loaded, a stale entry is replaced right away
+                        if(entry != entries.end())
+                        {
+                            erase(entry);
+                        }
+
+                        ++usage.misses;
+                        generation = ++lastGeneration;
+                        CacheEntry pending;
+                        pending.version = version;
+                        pending.image = promise.get_future().share();
+                        pending.generation = generation;
+                        entries.emplace(key, std::move(pending));
+                    }
+                }
+
+                // A pending decode is waited for outside of the lock
+                if(cached.valid())
+                {
+                    return cached.get();
+                }
+
+                CachedImage image = ErrorCodes::InvalidReadOperation;
+                try
+                {
+                    image = decode(key);
+                }
+                catch(...)
+                {
+                    promise.set_exception(std::current_exception());
+                    std::lock_guard<std::mutex> lock{mutex};
+                    auto entry = entries.find(key);
+                    if(entry != entries.end() && entry->second.generation == generation)
+                    {
+                        entries.erase(entry);
+                    }
+                    throw;
+                }
+
+                promise.set_value(image);
+
+                std::lock_guard<std::mutex> lock{mutex};
+                auto entry = entries.find(key);
+                if(entry == entries.end() || entry->second.generation != generation)
+                {
+                    return image;
+                }
+
+                if(std::holds_alternative<ErrorCodes>(image))
+                {
+                    entries.erase(entry);
+                    return image;
+                }
+
+                entry->second.decoded = true;
+                entry->second.bytes = static_cast<std::size_t>(std::get<std::shared_ptr<const TGAImage>>(image)->dataSize());
+                recentlyUsed.push_front(key);
+                entry->second.recentlyUsed = recentlyUsed.begin();
+                usage.bytes += entry->second.bytes;
+                ++usage.entries;
+
+                evict();
+                return image;
+            }
+
+            void clear()
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                for(auto entry = entries.begin(); entry != entries.end();)
+                {
+                    // Pending decodes finish without inserting their image
+                    entry = erase(entry);
+                }
+            }
+
+            ImageCacheUsage currentUsage() const
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                return usage;
+            }
+
+        private:
+            CachedImage decode(const std::string& imagePath)
+            {
+                auto result = loader.loadImage(imagePath);
+                if(std::holds_alternative<ErrorCodes>(result))
+                {
+                    return std::get<ErrorCodes>(result);
+                }
+
+                return std::shared_ptr<const TGAImage>{std::get<TGAImage*>(result)};
+            }
+
+            std::unordered_map<std::string, CacheEntry>::iterator erase(std::unordered_map<std::string, CacheEntry>::iterator entry)
+            {
+                if(entry->second.decoded)
+                {
+                    recentlyUsed.erase(entry->second.recentlyUsed);
+                    usage.bytes -= entry->second.bytes;
+                    --usage.entries;
+                }
+
+                return entries.erase(entry);
+            }
+
+            // The image just inserted may be dropped as well if it alone exceeds the budget
+            void evict()
+            {
+                while(usage.bytes > byteBudget && !recentlyUsed.empty())
+                {
+                    erase(entries.find(recentlyUsed.back()));
+                    ++usage.evictions;
+                }
+            }
+
+        private:
+            TGAImageLoader& loader;
+            std::size_t byteBudget{0};
+            std::uint64_t lastGeneration{0};
+            std::unordered_map<std::string, CacheEntry> entries;
+            // Keys of the decoded entries, most recently used first
+            std::list<std::string> recentlyUsed;
+            ImageCacheUsage usage;
+            mutable std::mutex mutex;
+    };
+
+    ImageCache::ImageCache(TGAImageLoader& loader, const std::size_t& byteBudget) : d_ptr{new ImageCacheImpl{loader, byteBudget}}
+    {
+
+    }
+
+    ImageCache::~ImageCache()
+    {
+
+    }
+
+    std::variant<std::shared_ptr<const TGAImage>, ErrorCodes> ImageCache::loadImage(const std::string_view& imagePath)
+    {
+        return d_ptr->loadImage(imagePath);
+    }
+
+    void ImageCache::clear()
+    {
+        d_ptr->clear();
+    }
+
+    ImageCacheUsage ImageCache::usage() const
+    {
+        return d_ptr->currentUsage();
+    }
+} // namespace imageloader
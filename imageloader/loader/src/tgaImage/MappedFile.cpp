@@ -0,0 +1,110 @@
+#include "MappedFile.hpp"
+
+#include <string>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace imageloader
+{
+    MappedFile::MappedFile(void* address, const std::size_t& size, void* mappingHandle) :
+                            address{address},
+                            length{size},
+                            handle{mappingHandle}
+    {
+
+    }
+
+#if defined(_WIN32)
+    std::variant<std::shared_ptr<MappedFile>, ErrorCodes> MappedFile::open(const std::string_view& filePath)
+    {
+        const auto path = std::string{filePath};
+        auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE)
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return ErrorCodes::InvalidReadOperation;
+        }
+
+        auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if(mapping == nullptr)
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        auto address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if(address == nullptr)
+        {
+            CloseHandle(mapping);
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        return std::shared_ptr<MappedFile>{new MappedFile{address, static_cast<std::size_t>(fileSize.QuadPart), mapping}};
+    }
+
+    MappedFile::~MappedFile()
+    {
+        UnmapViewOfFile(address);
+        CloseHandle(handle);
+    }
+#else
+    std::variant<std::shared_ptr<MappedFile>, ErrorCodes> MappedFile::open(const std::string_view& filePath)
+    {
+        const auto path = std::string{filePath};
+        const auto descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(descriptor < 0)
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        struct stat fileStatus{};
+        if(fstat(descriptor, &fileStatus) != 0 || fileStatus.st_size <= 0)
+        {
+            ::close(descriptor);
+            return ErrorCodes::InvalidReadOperation;
+        }
+
+        const auto size = static_cast<std::size_t>(fileStatus.st_size);
+        auto address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        // The mapping holds its own reference to the file, descriptor is not needed anymore
+        ::close(descriptor);
+        if(address == MAP_FAILED)
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        return std::shared_ptr<MappedFile>{new MappedFile{address, size, nullptr}};
+    }
+
+    MappedFile::~MappedFile()
+    {
+        munmap(address, length);
+    }
+#endif
+
+    const std::uint8_t* MappedFile::data() const
+    {
+        return static_cast<const std::uint8_t*>(address);
+    }
+
+    std::size_t MappedFile::size() const
+    {
+        return length;
+    }
+} // namespace imageloader
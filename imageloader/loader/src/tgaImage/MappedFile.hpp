@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <variant>
+
+#include "ErrorCodes.hpp"
+
+namespace imageloader
+{
+    // Read-only mapping of a whole file. Instances are always handled through std::shared_ptr,
+    // so pixel views handed out to TGAImage keep the mapping alive through the aliasing constructor.
+    class MappedFile
+    {
+        public:
+            static std::variant<std::shared_ptr<MappedFile>, ErrorCodes> open(const std::string_view& filePath);
+
+            ~MappedFile();
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const std::uint8_t* data() const;
+            std::size_t size() const;
+
+        private:
+            MappedFile(void* address, const std::size_t& size, void* mappingHandle);
+
+        private:
+            void* address{nullptr};
+            std::size_t length{0};
+            void* handle{nullptr};
+    };
+} // namespace imageloader
@@ -0,0 +1,154 @@
+#include "MetricsRecorder.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+namespace imageloader
+{
+    namespace
+    {
+        // Spans beyond this are dropped, so a forgotten trace cannot grow without bounds
+        constexpr std::size_t maxTraceSpans = 1024*1024;
+
+        thread_local StageTimer* activeTimer{nullptr};
+
+        // Small consecutive thread numbers read better in trace viewers than hashed thread ids
+        std::uint32_t traceThread()
+        {
+            static std::atomic<std::uint32_t> nextThread{1};
+            thread_local const auto thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+            return thread;
+        }
+    } // namespace
+
+    const char* loadStageName(const loadStage& stage)
+    {
+        static const char* names[] = {"path_check", "open", "header", "allocate", "read", "decode", "convert", "encode", "write"};
+        return stage < loadStage::COUNT ? names[static_cast<std::size_t>(stage)] : "unknown";
+    }
+
+    MetricsRecorder::MetricsRecorder() : origin{std::chrono::steady_clock::now()}
+    {
+
+    }
+
+    void MetricsRecorder::enableMetrics(const bool& enabled)
+    {
+        collectMetrics.store(enabled, std::memory_order_relaxed);
+    }
+
+    void MetricsRecorder::enableTracing(const bool& enabled)
+    {
+        collectSpans.store(enabled, std::memory_order_relaxed);
+    }
+
+    void MetricsRecorder::addStage(const loadStage& stage, const std::chrono::steady_clock::time_point& start,
+                                   const std::uint64_t& nanoseconds, const std::uint64_t& exclusiveNanoseconds)
+    {
+        const auto index = static_cast<std::size_t>(stage);
+        if(metricsEnabled())
+        {
+            stageNanoseconds[index].fetch_add(exclusiveNanoseconds, std::memory_order_relaxed);
+            stageCalls[index].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if(tracingEnabled())
+        {
+            const auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count();
+            std::lock_guard<std::mutex> lock{spansMutex};
+            if(spans.size() < maxTraceSpans)
+            {
+                spans.push_back(TraceSpan{stage, traceThread(), static_cast<std::uint64_t>(offset), nanoseconds});
+            }
+        }
+    }
+
+    LoaderMetrics MetricsRecorder::snapshot() const
+    {
+        LoaderMetrics metrics;
+        for(std::size_t stage = 0; stage < loadStageCount; ++stage)
+        {
+            metrics.stageNanoseconds[stage] = stageNanoseconds[stage].load(std::memory_order_relaxed);
+            metrics.stageCalls[stage] = stageCalls[stage].load(std::memory_order_relaxed);
+        }
+
+        auto counter = [this](const metricCounter& name) { return counters[static_cast<std::size_t>(name)].load(std::memory_order_relaxed); };
+        metrics.bytesRead = counter(metricCounter::BYTES_READ);
+        metrics.bytesWritten = counter(metricCounter::BYTES_WRITTEN);
+        metrics.packetsDecoded = counter(metricCounter::PACKETS_DECODED);
+        metrics.allocations = counter(metricCounter::ALLOCATIONS);
+        metrics.allocatedBytes = counter(metricCounter::ALLOCATED_BYTES);
+        metrics.imagesLoaded = counter(metricCounter::IMAGES_LOADED);
+        metrics.imagesStored = counter(metricCounter::IMAGES_STORED);
+
+        return metrics;
+    }
+
+    void MetricsRecorder::reset()
+    {
+        for(std::size_t stage = 0; stage < loadStageCount; ++stage)
+        {
+            stageNanoseconds[stage].store(0, std::memory_order_relaxed);
+            stageCalls[stage].store(0, std::memory_order_relaxed);
+        }
+
+        for(auto& counter : counters)
+        {
+            counter.store(0, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock{spansMutex};
+        spans.clear();
+    }
+
+    std::optional<ErrorCodes> MetricsRecorder::writeTrace(const std::string_view& tracePath) const
+    {
+        std::ofstream traceFile(std::string{tracePath}, std::ios::out | std::ios::trunc);
+        if(!traceFile.is_open())
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        traceFile << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        {
+            std::lock_guard<std::mutex> lock{spansMutex};
+            for(std::size_t index = 0; index < spans.size(); ++index)
+            {
+                const auto& span = spans[index];
+                // Timestamps and durations are in microseconds, fractions keep the nanoseconds
+                traceFile << (index == 0 ? "" : ",") << "\n{\"name\":\"" << loadStageName(span.stage)
+                          << "\",\"cat\":\"imageloader\",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.thread
+                          << ",\"ts\":" << span.start/1000 << "." << std::to_string(1000 + span.start%1000).substr(1)
+                          << ",\"dur\":" << span.duration/1000 << "." << std::to_string(1000 + span.duration%1000).substr(1) << "}";
+            }
+        }
+
+        traceFile << "\n]}\n";
+        return traceFile.good() ? std::nullopt : std::optional<ErrorCodes>{ErrorCodes::InvalidWriteOperation};
+    }
+
+    void StageTimer::start(MetricsRecorder& stageRecorder, const loadStage& timedStage)
+    {
+        recorder = &stageRecorder;
+        stage = timedStage;
+        parent = activeTimer;
+        activeTimer = this;
+        startTime = std::chrono::steady_clock::now();
+    }
+
+    void StageTimer::stop()
+    {
+        const auto nanoseconds = static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+
+        activeTimer = parent;
+        if(parent != nullptr)
+        {
+            parent->nestedNanoseconds += nanoseconds;
+        }
+
+        recorder->addStage(stage, startTime, nanoseconds, nanoseconds - std::min(nanoseconds, nestedNanoseconds));
+    }
+} // namespace imageloader
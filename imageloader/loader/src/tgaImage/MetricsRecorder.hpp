@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "ErrorCodes.hpp"
+#include "tgaImage/LoaderMetrics.hpp"
+
+namespace imageloader
+{
+    enum class metricCounter
+    {
+        BYTES_READ,
+        BYTES_WRITTEN,
+        PACKETS_DECODED,
+        ALLOCATIONS,
+        ALLOCATED_BYTES,
+        IMAGES_LOADED,
+        IMAGES_STORED,
+        COUNT
+    };
+
+    // Counters of a loader. Everything is off until enabled, then counters are updated with relaxed atomics, so
+    // threads never wait for each other. Without IMAGELOADER_METRICS all recording compiles to nothing.
+    class MetricsRecorder
+    {
+        public:
+            MetricsRecorder();
+
+            void enableMetrics(const bool& enabled);
+            void enableTracing(const bool& enabled);
+
+            bool metricsEnabled() const
+            {
+#if defined(IMAGELOADER_METRICS)
+                return collectMetrics.load(std::memory_order_relaxed);
+#else
+                return false;
+#endif
+            }
+
+            bool tracingEnabled() const
+            {
+#if defined(IMAGELOADER_METRICS)
+                return collectSpans.load(std::memory_order_relaxed);
+#else
+                return false;
+#endif
+            }
+
+            void count(const metricCounter& counter, const std::uint64_t& value)
+            {
+                if(metricsEnabled())
+                {
+                    counters[static_cast<std::size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+                }
+            }
+
+            // exclusiveNanoseconds go to the stage totals, the span covers the whole duration including nested stages
+            void addStage(const loadStage& stage, const std::chrono::steady_clock::time_point& start,
+                          const std::uint64_t& nanoseconds, const std::uint64_t& exclusiveNanoseconds);
+
+            LoaderMetrics snapshot() const;
+            void reset();
+
+            // Chrome trace event format, opened by chrome://tracing and the Perfetto UI
+            std::optional<ErrorCodes> writeTrace(const std::string_view& tracePath) const;
+
+        private:
+            struct TraceSpan
+            {
+                loadStage stage;
+                std::uint32_t thread;
+                std::uint64_t start;
+                std::uint64_t duration;
+            };
+
+            std::atomic<bool> collectMetrics{false};
+            std::atomic<bool> collectSpans{false};
+            std::array<std::atomic<std::uint64_t>, loadStageCount> stageNanoseconds{};
+            std::array<std::atomic<std::uint64_t>, loadStageCount> stageCalls{};
+            std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(metricCounter::COUNT)> counters{};
+
+            // Span timestamps are relative to the creation of the recorder
+            std::chrono::steady_clock::time_point origin;
+            std::vector<TraceSpan> spans;
+            mutable std::mutex spansMutex;
+    };
+
+    // Times a stage from construction to destruction. Timers nest per thread, time spent in an inner timer is
+    // subtracted from the outer one, so stage totals add up to the wall time of the outermost stages.
+    class StageTimer
+    {
+        public:
+            StageTimer(MetricsRecorder& recorder, const loadStage& stage)
+            {
+                if(recorder.metricsEnabled() || recorder.tracingEnabled())
+                {
+                    start(recorder, stage);
+                }
+            }
+
+            ~StageTimer()
+            {
+                if(recorder != nullptr)
+                {
+                    stop();
+                }
+            }
+
+            StageTimer(const StageTimer&) = delete;
+            StageTimer& operator=(const StageTimer&) = delete;
+
+        private:
+            void start(MetricsRecorder& stageRecorder, const loadStage& timedStage);
+            void stop();
+
+        private:
+            MetricsRecorder* recorder{nullptr};
+            loadStage stage{loadStage::COUNT};
+            std::chrono::steady_clock::time_point startTime;
+            std::uint64_t nestedNanoseconds{0};
+            StageTimer* parent{nullptr};
+    };
+} // namespace imageloader
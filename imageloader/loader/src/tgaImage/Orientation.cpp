@@ -0,0 +1,184 @@
+#include "Orientation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define IMAGELOADER_FLIP_SSE2
+    #include <emmintrin.h>
+    #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        #define IMAGELOADER_FLIP_SSSE3
+        #include <immintrin.h>
+    #endif
+#endif
+
+namespace imageloader
+{
+    namespace
+    {
+        // Rows are swapped through a bounce buffer of this size
+        constexpr std::size_t swapBlockSize = 16*1024;
+
+        // Swaps byte by byte, so pixels of any width are handled
+        void reversePixelsScalar(std::uint8_t* left, std::uint8_t* right, const int& bytesPerPixel)
+        {
+            for(right -= bytesPerPixel; left < right; left += bytesPerPixel, right -= bytesPerPixel)
+            {
+                std::swap_ranges(left, left + bytesPerPixel, right);
+            }
+        }
+
+        // Every kernel swaps blocks from both ends of [left, right) and returns the unprocessed middle
+        using ReverseKernel = void (*)(std::uint8_t*& left, std::uint8_t*& right);
+
+    #if defined(IMAGELOADER_FLIP_SSE2)
+        void reverseWordsSSE2(std::uint8_t*& left, std::uint8_t*& right)
+        {
+            const auto reverse = [](const __m128i& value)
+            {
+                const auto words = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+                return _mm_shuffle_epi32(words, _MM_SHUFFLE(1, 0, 3, 2));
+            };
+
+            for(; right - left >= 32; left += 16, right -= 16)
+            {
+                const auto head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left));
+                const auto tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right - 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(left), reverse(tail));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(right - 16), reverse(head));
+            }
+        }
+
+        void reverseDoubleWordsSSE2(std::uint8_t*& left, std::uint8_t*& right)
+        {
+            for(; right - left >= 32; left += 16, right -= 16)
+            {
+                const auto head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left));
+                const auto tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right - 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(left), _mm_shuffle_epi32(tail, _MM_SHUFFLE(0, 1, 2, 3)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(right - 16), _mm_shuffle_epi32(head, _MM_SHUFFLE(0, 1, 2, 3)));
+            }
+        }
+    #endif
+
+    #if defined(IMAGELOADER_FLIP_SSSE3)
+        __attribute__((target("ssse3")))
+        void reverseBytesSSSE3(std::uint8_t*& left, std::uint8_t*& right)
+        {
+            const auto mask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+            for(; right - left >= 32; left += 16, right -= 16)
+            {
+                const auto head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left));
+                const auto tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right - 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(left), _mm_shuffle_epi8(tail, mask));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(right - 16), _mm_shuffle_epi8(head, mask));
+            }
+        }
+
+        // Four 3 byte pixels per step, the head block uses the first and the tail block the last 12 bytes of a load
+        __attribute__((target("ssse3")))
+        void reverseTriplesSSSE3(std::uint8_t*& left, std::uint8_t*& right)
+        {
+            const auto headMask = _mm_setr_epi8(9, 10, 11, 6, 7, 8, 3, 4, 5, 0, 1, 2, -128, -128, -128, -128);
+            const auto tailMask = _mm_setr_epi8(13, 14, 15, 10, 11, 12, 7, 8, 9, 4, 5, 6, -128, -128, -128, -128);
+
+            const auto store = [](std::uint8_t* destination, const __m128i& value)
+            {
+                const auto last = _mm_cvtsi128_si32(_mm_srli_si128(value, 8));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(destination), value);
+                std::memcpy(destination + 8, &last, sizeof(last));
+            };
+
+            for(; right - left >= 32; left += 12, right -= 12)
+            {
+                const auto head = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(left)), headMask);
+                const auto tail = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(right - 16)), tailMask);
+                store(left, tail);
+                store(right - 12, head);
+            }
+        }
+    #endif
+
+        bool supportsSSSE3()
+        {
+        #if defined(IMAGELOADER_FLIP_SSSE3)
+            static const bool supported = __builtin_cpu_supports("ssse3");
+            return supported;
+        #else
+            return false;
+        #endif
+        }
+
+        ReverseKernel selectReverseKernel(const int& bytesPerPixel)
+        {
+        #if defined(IMAGELOADER_FLIP_SSSE3)
+            if(supportsSSSE3() && bytesPerPixel == 1)
+            {
+                return reverseBytesSSSE3;
+            }
+
+            if(supportsSSSE3() && bytesPerPixel == 3)
+            {
+                return reverseTriplesSSSE3;
+            }
+        #endif
+        #if defined(IMAGELOADER_FLIP_SSE2)
+            if(bytesPerPixel == 2)
+            {
+                return reverseWordsSSE2;
+            }
+
+            if(bytesPerPixel == 4)
+            {
+                return reverseDoubleWordsSSE2;
+            }
+        #endif
+
+            return nullptr;
+        }
+    } // namespace
+
+    void reversePixels(std::uint8_t* row, const std::size_t& pixelCount, const int& bytesPerPixel)
+    {
+        if(bytesPerPixel <= 0 || pixelCount < 2)
+        {
+            return;
+        }
+
+        auto left = row;
+        auto right = row + pixelCount*bytesPerPixel;
+
+        if(const auto kernel = selectReverseKernel(bytesPerPixel); kernel != nullptr)
+        {
+            kernel(left, right);
+        }
+
+        reversePixelsScalar(left, right, bytesPerPixel);
+    }
+
+    void reverseRows(const ImageView& image)
+    {
+        if(image.empty())
+        {
+            return;
+        }
+
+        std::array<std::uint8_t, swapBlockSize> buffer;
+        const auto rowSize = image.rowSize();
+
+        for(auto top = 0, bottom = image.height() - 1; top < bottom; ++top, --bottom)
+        {
+            const auto upper = image.row(top);
+            const auto lower = image.row(bottom);
+            for(std::size_t offset = 0; offset < rowSize; offset += swapBlockSize)
+            {
+                const auto size = std::min(swapBlockSize, rowSize - offset);
+                std::memcpy(buffer.data(), upper + offset, size);
+                std::memcpy(upper + offset, lower + offset, size);
+                std::memcpy(lower + offset, buffer.data(), size);
+            }
+        }
+    }
+} // namespace imageloader
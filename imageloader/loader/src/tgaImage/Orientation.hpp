@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tgaImage/ImageView.hpp"
+
+namespace imageloader
+{
+    // Reverses the order of pixelCount pixels in place, rows are reversed from both ends with SIMD byte shuffles
+    void reversePixels(std::uint8_t* row, const std::size_t& pixelCount, const int& bytesPerPixel);
+
+    // Swaps row y with row height - 1 - y in place
+    void reverseRows(const ImageView& image);
+} // namespace imageloader
@@ -0,0 +1,194 @@
+#include "tgaImage/PixelBuffer.hpp"
+
+#include <cstring>
+#include <new>
+
+#include "tgaImage/Constants.hpp"
+
+namespace imageloader
+{
+    namespace
+    {
+        constexpr std::align_val_t pixelAlignment{imageloader::tgaimage::constants::PIXEL_BUFFER_ALIGNMENT};
+
+        std::uint8_t* allocateAligned(const std::size_t& size)
+        {
+            return static_cast<std::uint8_t*>(::operator new(size, pixelAlignment));
+        }
+
+        void deallocateAligned(std::uint8_t* data)
+        {
+            ::operator delete(data, pixelAlignment);
+        }
+
+        class AlignedAllocator : public PixelAllocator
+        {
+            public:
+                std::uint8_t* allocate(const std::size_t& size) override
+                {
+                    return allocateAligned(size);
+                }
+
+                void deallocate(std::uint8_t* data, const std::size_t&) override
+                {
+                    deallocateAligned(data);
+                }
+        };
+    } // namespace
+
+    std::shared_ptr<PixelAllocator> defaultPixelAllocator()
+    {
+        static const auto allocator = std::make_shared<AlignedAllocator>();
+        return allocator;
+    }
+
+    BufferPool::BufferPool(const std::size_t& maxCachedBytes) : maxCachedBytes{maxCachedBytes}
+    {
+
+    }
+
+    BufferPool::~BufferPool()
+    {
+        trim();
+    }
+
+    std::uint8_t* BufferPool::allocate(const std::size_t& size)
+    {
+        {
+            std::lock_guard lock{mutex};
+            auto found = freeBuffers.find(size);
+            if(found != freeBuffers.end() && !found->second.empty())
+            {
+                auto data = found->second.back();
+                found->second.pop_back();
+                currentCachedBytes -= size;
+                return data;
+            }
+        }
+
+        return allocateAligned(size);
+    }
+
+    void BufferPool::deallocate(std::uint8_t* data, const std::size_t& size)
+    {
+        {
+            std::lock_guard lock{mutex};
+            if(currentCachedBytes + size <= maxCachedBytes)
+            {
+                freeBuffers[size].push_back(data);
+                currentCachedBytes += size;
+                return;
+            }
+        }
+
+        deallocateAligned(data);
+    }
+
+    std::size_t BufferPool::cachedBytes() const
+    {
+        std::lock_guard lock{mutex};
+        return currentCachedBytes;
+    }
+
+    void BufferPool::trim()
+    {
+        std::unordered_map<std::size_t, std::vector<std::uint8_t*>> released;
+        {
+            std::lock_guard lock{mutex};
+            released.swap(freeBuffers);
+            currentCachedBytes = 0;
+        }
+
+        for(auto& [size, buffers] : released)
+        {
+            for(auto data : buffers)
+            {
+                deallocateAligned(data);
+            }
+        }
+    }
+
+    PixelBuffer::PixelBuffer(std::shared_ptr<PixelAllocator> allocator, const std::size_t& size) :
+                              allocator{std::move(allocator)},
+                              length{size}
+    {
+        buffer = this->allocator->allocate(size);
+    }
+
+    PixelBuffer::~PixelBuffer()
+    {
+        reset();
+    }
+
+    PixelBuffer::PixelBuffer(const PixelBuffer& rhs)
+    {
+        if(rhs.allocator)
+        {
+            allocator = rhs.allocator;
+            length = rhs.length;
+            buffer = allocator->allocate(length);
+            std::memcpy(buffer, rhs.buffer, length);
+        }
+    }
+
+    PixelBuffer::PixelBuffer(PixelBuffer&& rhs) noexcept :
+                              allocator{std::move(rhs.allocator)},
+                              buffer{rhs.buffer},
+                              length{rhs.length}
+    {
+        rhs.buffer = nullptr;
+        rhs.length = 0;
+    }
+
+    PixelBuffer& PixelBuffer::operator=(const PixelBuffer& rhs)
+    {
+        if(&rhs != this)
+        {
+            PixelBuffer copy{rhs};
+            *this = std::move(copy);
+        }
+
+        return *this;
+    }
+
+    PixelBuffer& PixelBuffer::operator=(PixelBuffer&& rhs) noexcept
+    {
+        if(&rhs != this)
+        {
+            reset();
+            allocator = std::move(rhs.allocator);
+            buffer = rhs.buffer;
+            length = rhs.length;
+            rhs.buffer = nullptr;
+            rhs.length = 0;
+        }
+
+        return *this;
+    }
+
+    std::uint8_t* PixelBuffer::data() const
+    {
+        return buffer;
+    }
+
+    std::size_t PixelBuffer::size() const
+    {
+        return length;
+    }
+
+    PixelBuffer::operator bool() const
+    {
+        return allocator != nullptr;
+    }
+
+    void PixelBuffer::reset()
+    {
+        if(allocator)
+        {
+            allocator->deallocate(buffer, length);
+            allocator.reset();
+        }
+        buffer = nullptr;
+        length = 0;
+    }
+} // namespace imageloader
@@ -0,0 +1,627 @@
+#include "tgaImage/PixelFormat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "TGAFormat.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define IMAGELOADER_CONVERT_SSE2
+    #include <emmintrin.h>
+    #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        #define IMAGELOADER_CONVERT_SSSE3
+        #include <immintrin.h>
+    #endif
+#endif
+
+namespace imageloader
+{
+    namespace
+    {
+        // Pixels converted at once by the scalar path, the intermediate BGRA block stays in L1
+        constexpr std::size_t conversionChunkPixels = 256;
+        constexpr std::uint8_t opaqueAlpha = 0xFF;
+
+        bool isPremultiplied(const pixelFormat& format)
+        {
+            return format == pixelFormat::BGRA_PREMULTIPLIED || format == pixelFormat::RGBA_PREMULTIPLIED;
+        }
+
+        // Exact round(value/255) for value in [0, 255*255]
+        std::uint8_t divideBy255(const unsigned int& value)
+        {
+            const auto rounded = value + 128;
+            return static_cast<std::uint8_t>((rounded + (rounded>>8))>>8);
+        }
+
+        std::uint8_t expand5(const unsigned int& value)
+        {
+            return static_cast<std::uint8_t>((value<<3) | (value>>2));
+        }
+
+        // Stored pixels to BGRA, premultiplied formats stay premultiplied
+        void unpackToBGRA(const std::uint8_t* input, const pixelFormat& format, std::uint8_t* output, const std::size_t& pixelCount)
+        {
+            for(std::size_t index = 0; index < pixelCount; ++index, output += 4)
+            {
+                switch(format)
+                {
+                    case pixelFormat::GRAY:
+                        output[0] = output[1] = output[2] = input[index];
+                        output[3] = opaqueAlpha;
+                        break;
+                    case pixelFormat::BGR555:
+                    case pixelFormat::BGRA5551:
+                    {
+                        const unsigned int value = input[2*index] | (input[2*index + 1]<<8);
+                        output[0] = expand5(value & 0x1F);
+                        output[1] = expand5((value>>5) & 0x1F);
+                        output[2] = expand5((value>>10) & 0x1F);
+                        output[3] = (format == pixelFormat::BGR555 || (value & 0x8000) != 0) ? opaqueAlpha : 0;
+                        break;
+                    }
+                    case pixelFormat::BGR:
+                        std::memcpy(output, input + 3*index, 3);
+                        output[3] = opaqueAlpha;
+                        break;
+                    case pixelFormat::RGB:
+                        output[0] = input[3*index + 2];
+                        output[1] = input[3*index + 1];
+                        output[2] = input[3*index];
+                        output[3] = opaqueAlpha;
+                        break;
+                    case pixelFormat::BGRA:
+                    case pixelFormat::BGRA_PREMULTIPLIED:
+                        std::memcpy(output, input + 4*index, 4);
+                        break;
+                    case pixelFormat::RGBA:
+                    case pixelFormat::RGBA_PREMULTIPLIED:
+                        output[0] = input[4*index + 2];
+                        output[1] = input[4*index + 1];
+                        output[2] = input[4*index];
+                        output[3] = input[4*index + 3];
+                        break;
+                }
+            }
+        }
+
+        void packFromBGRA(const std::uint8_t* input, std::uint8_t* output, const pixelFormat& format, const std::size_t& pixelCount)
+        {
+            for(std::size_t index = 0; index < pixelCount; ++index, input += 4)
+            {
+                switch(format)
+                {
+                    case pixelFormat::GRAY:
+                        output[index] = static_cast<std::uint8_t>((29*input[0] + 150*input[1] + 77*input[2] + 128)>>8);
+                        break;
+                    case pixelFormat::BGR555:
+                    case pixelFormat::BGRA5551:
+                    {
+                        auto value = (input[0]>>3) | ((input[1]>>3)<<5) | ((input[2]>>3)<<10);
+                        if(format == pixelFormat::BGRA5551 && input[3] >= 0x80)
+                        {
+                            value |= 0x8000;
+                        }
+                        output[2*index] = static_cast<std::uint8_t>(value);
+                        output[2*index + 1] = static_cast<std::uint8_t>(value>>8);
+                        break;
+                    }
+                    case pixelFormat::BGR:
+                        std::memcpy(output + 3*index, input, 3);
+                        break;
+                    case pixelFormat::RGB:
+                        output[3*index] = input[2];
+                        output[3*index + 1] = input[1];
+                        output[3*index + 2] = input[0];
+                        break;
+                    case pixelFormat::BGRA:
+                    case pixelFormat::BGRA_PREMULTIPLIED:
+                        std::memcpy(output + 4*index, input, 4);
+                        break;
+                    case pixelFormat::RGBA:
+                    case pixelFormat::RGBA_PREMULTIPLIED:
+                        output[4*index] = input[2];
+                        output[4*index + 1] = input[1];
+                        output[4*index + 2] = input[0];
+                        output[4*index + 3] = input[3];
+                        break;
+                }
+            }
+        }
+
+        void premultiplyBGRA(std::uint8_t* pixels, const std::size_t& pixelCount)
+        {
+            for(std::size_t index = 0; index < pixelCount; ++index, pixels += 4)
+            {
+                for(auto channel = 0; channel < 3; ++channel)
+                {
+                    pixels[channel] = divideBy255(pixels[channel]*pixels[3]);
+                }
+            }
+        }
+
+        void unpremultiplyBGRA(std::uint8_t* pixels, const std::size_t& pixelCount)
+        {
+            for(std::size_t index = 0; index < pixelCount; ++index, pixels += 4)
+            {
+                const unsigned int alpha = pixels[3];
+                for(auto channel = 0; channel < 3; ++channel)
+                {
+                    pixels[channel] = alpha == 0 ? 0 : static_cast<std::uint8_t>(std::min(255u, (pixels[channel]*255u + alpha/2)/alpha));
+                }
+            }
+        }
+
+        // Any to any conversion through blocks of BGRA pixels
+        void convertScalar(const std::uint8_t* input, const pixelFormat& inputFormat,
+                           std::uint8_t* output, const pixelFormat& outputFormat, const std::size_t& pixelCount)
+        {
+            const std::size_t inputBytes = bytesPerPixel(inputFormat);
+            const std::size_t outputBytes = bytesPerPixel(outputFormat);
+
+            std::array<std::uint8_t, conversionChunkPixels*4> chunk;
+            for(std::size_t first = 0; first < pixelCount; first += conversionChunkPixels)
+            {
+                const auto count = std::min(conversionChunkPixels, pixelCount - first);
+                unpackToBGRA(input + first*inputBytes, inputFormat, chunk.data(), count);
+
+                if(isPremultiplied(inputFormat) && !isPremultiplied(outputFormat))
+                {
+                    unpremultiplyBGRA(chunk.data(), count);
+                }
+                else if(!isPremultiplied(inputFormat) && isPremultiplied(outputFormat))
+                {
+                    premultiplyBGRA(chunk.data(), count);
+                }
+
+                packFromBGRA(chunk.data(), output + first*outputBytes, outputFormat, count);
+            }
+        }
+
+        // Vectorized kernels convert a prefix of the pixels and return its length, the rest goes through convertScalar
+        using ConversionKernel = std::size_t (*)(const std::uint8_t* input, std::uint8_t* output, const std::size_t& pixelCount);
+
+    #if defined(IMAGELOADER_CONVERT_SSE2)
+        // Gray to any 4 byte format, alpha is opaque so premultiplication does not change anything
+        std::size_t grayToQuadSSE2(const std::uint8_t* input, std::uint8_t* output, const std::size_t& pixelCount)
+        {
+            const auto alpha = _mm_set1_epi8(static_cast<char>(opaqueAlpha));
+
+            std::size_t index = 0;
+            for(; index + 16 <= pixelCount; index += 16)
+            {
+                const auto gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + index));
+                const auto grayGrayLow = _mm_unpacklo_epi8(gray, gray);
+                const auto grayGrayHigh = _mm_unpackhi_epi8(gray, gray);
+                const auto grayAlphaLow = _mm_unpacklo_epi8(gray, alpha);
+                const auto grayAlphaHigh = _mm_unpackhi_epi8(gray, alpha);
+
+                auto destination = reinterpret_cast<__m128i*>(output + 4*index);
+                _mm_storeu_si128(destination, _mm_unpacklo_epi16(grayGrayLow, grayAlphaLow));
+                _mm_storeu_si128(destination + 1, _mm_unpackhi_epi16(grayGrayLow, grayAlphaLow));
+                _mm_storeu_si128(destination + 2, _mm_unpacklo_epi16(grayGrayHigh, grayAlphaHigh));
+                _mm_storeu_si128(destination + 3, _mm_unpackhi_epi16(grayGrayHigh, grayAlphaHigh));
+            }
+
+            return index;
+        }
+
+        template<bool swapRedBlue, bool hasAlpha>
+        std::size_t expand555SSE2(const std::uint8_t* input, std::uint8_t* output, const std::size_t& pixelCount)
+        {
+            const auto channelMask = _mm_set1_epi16(0x1F);
+            const auto byteMask = _mm_set1_epi16(0xFF);
+
+            const auto expand = [](const __m128i& value)
+            {
+                return _mm_or_si128(_mm_slli_epi16(value, 3), _mm_srli_epi16(value, 2));
+            };
+
+            std::size_t index = 0;
+            for(; index + 8 <= pixelCount; index += 8)
+            {
+                const auto value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2*index));
+                const auto blue = expand(_mm_and_si128(value, channelMask));
+                const auto green = expand(_mm_and_si128(_mm_srli_epi16(value, 5), channelMask));
+                const auto red = expand(_mm_and_si128(_mm_srli_epi16(value, 10), channelMask));
+                const auto alpha = hasAlpha ? _mm_and_si128(_mm_srai_epi16(value, 15), byteMask) : byteMask;
+
+                const auto firstPair = _mm_or_si128(swapRedBlue ? red : blue, _mm_slli_epi16(green, 8));
+                const auto secondPair = _mm_or_si128(swapRedBlue ? blue : red, _mm_slli_epi16(alpha, 8));
+
+                auto destination = reinterpret_cast<__m128i*>(output + 4*index);
+                _mm_storeu_si128(destination, _mm_unpacklo_epi16(firstPair, secondPair));
+                _mm_storeu_si128(destination + 1, _mm_unpackhi_epi16(firstPair, secondPair));
+            }
+
+            return index;
+        }
+
+        // Multiplies the first three bytes of every 4 byte pixel by the fourth one, works for BGRA and RGBA alike
+        std::size_t premultiplySSE2(const std::uint8_t* input, std::uint8_t* output, const std::size_t& pixelCount)
+        {
+            const auto zero = _mm_setzero_si128();
+            const auto rounding = _mm_set1_epi16(128);
+            // Alpha is multiplied by 255 and therefore kept as it is
+            const auto alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            const auto alphaFactor = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+
+            const auto premultiply = [&](const __m128i& pixels)
+            {
+                const auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                const auto factor = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), alphaFactor);
+                const auto product = _mm_add_epi16(_mm_mullo_epi16(pixels, factor), rounding);
+                return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+            };
+
+            std::size_t index = 0;
+            for(; index + 4 <= pixelCount; index += 4)
+            {
+                const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 4*index));
+                const auto low = premultiply(_mm_unpacklo_epi8(pixels, zero));
+                const auto high = premultiply(_mm_unpackhi_epi8(pixels, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4*index), _mm_packus_epi16(low, high));
+            }
+
+            return index;
+        }
+    #endif
+
+    #if defined(IMAGELOADER_CONVERT_SSSE3)
+        // Byte shuffles between BGR(A) and RGB(A), masks select source bytes, 0x80 produces zero
+        __attribute__((target("ssse3")))
+        std::size_t shuffleQuadSSSE3(const std::uint8_t* input, std::uint8_t* output, const std::size_t& pixelCount)
+        {
+            const auto mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+            std::size_t index = 0;
+            for(; index + 4 <= pixelCount; index += 4)
+            {
+                const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 4*index));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4*index), _mm_shuffle_epi8(pixels, mask));
+            }
+
+            return index;
+        }
+
+        // Five pixels per step, the sixteenth byte is written back unchanged and fixed by the next step
+        __attribute__((target("ssse3")))
+        std::size_t shuffleTripleSSSE3(const std::uint8_t* input, std::uint8_t* output, const std::size_t& pixelCount)
+        {
+            const auto mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+
+            std::size_t index = 0;
+            for(; index + 6 <= pixelCount; index += 5)
+            {
+                const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 3*index));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 3*index), _mm_shuffle_epi8(pixels, mask));
+            }
+
+            return index;
+        }
+
+        template<bool swapRedBlue>
+        __attribute__((target("ssse3")))
+        std::size_t tripleToQuadSSSE3(const std::uint8_t* input, std::uint8_t* output, const std::size_t& pixelCount)
+        {
+            const auto mask = swapRedBlue ? _mm_setr_epi8(2, 1, 0, -128, 5, 4, 3, -128, 8, 7, 6, -128, 11, 10, 9, -128)
+                                          : _mm_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+            const auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+            // Sixteen bytes are loaded for twelve used ones, so the last pixels are left to the scalar path
+            std::size_t index = 0;
+            for(; index + 6 <= pixelCount; index += 4)
+            {
+                const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 3*index));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4*index), _mm_or_si128(_mm_shuffle_epi8(pixels, mask), alpha));
+            }
+
+            return index;
+        }
+
+        template<bool swapRedBlue>
+        __attribute__((target("ssse3")))
+        std::size_t quadToTripleSSSE3(const std::uint8_t* input, std::uint8_t* output, const std::size_t& pixelCount)
+        {
+            const auto mask = swapRedBlue ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -128, -128, -128, -128)
+                                          : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128);
+
+            std::size_t index = 0;
+            for(; index + 4 <= pixelCount; index += 4)
+            {
+                const auto pixels = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 4*index)), mask);
+                const auto tail = _mm_cvtsi128_si32(_mm_srli_si128(pixels, 8));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(output + 3*index), pixels);
+                std::memcpy(output + 3*index + 8, &tail, sizeof(tail));
+            }
+
+            return index;
+        }
+    #endif
+
+        bool hasBlueFirst(const pixelFormat& format)
+        {
+            return format == pixelFormat::BGR555 || format == pixelFormat::BGRA5551 || format == pixelFormat::BGR ||
+                   format == pixelFormat::BGRA || format == pixelFormat::BGRA_PREMULTIPLIED;
+        }
+
+        bool supportsSSSE3()
+        {
+        #if defined(IMAGELOADER_CONVERT_SSSE3)
+            static const bool supported = __builtin_cpu_supports("ssse3");
+            return supported;
+        #else
+            return false;
+        #endif
+        }
+
+        // Vectorized kernel for a pair of formats, nullptr if the pair only has the scalar implementation
+        ConversionKernel selectKernel(const pixelFormat& inputFormat, const pixelFormat& outputFormat)
+        {
+            const auto inputBytes = bytesPerPixel(inputFormat);
+            const auto outputBytes = bytesPerPixel(outputFormat);
+            const auto swapRedBlue = hasBlueFirst(inputFormat) != hasBlueFirst(outputFormat);
+            const auto straightInput = !isPremultiplied(inputFormat);
+            const auto straightOutput = !isPremultiplied(outputFormat);
+
+        #if defined(IMAGELOADER_CONVERT_SSE2)
+            if(inputFormat == pixelFormat::GRAY && outputBytes == 4)
+            {
+                return grayToQuadSSE2;
+            }
+
+            if(inputFormat == pixelFormat::BGR555 && outputBytes == 4)
+            {
+                return swapRedBlue ? expand555SSE2<true, false> : expand555SSE2<false, false>;
+            }
+
+            // Transparent pixels would need their color cleared in premultiplied outputs
+            if(inputFormat == pixelFormat::BGRA5551 && outputBytes == 4 && straightOutput)
+            {
+                return swapRedBlue ? expand555SSE2<true, true> : expand555SSE2<false, true>;
+            }
+
+            if(inputBytes == 4 && outputBytes == 4 && !swapRedBlue && straightInput && !straightOutput)
+            {
+                return premultiplySSE2;
+            }
+        #endif
+
+            if(supportsSSSE3())
+            {
+            #if defined(IMAGELOADER_CONVERT_SSSE3)
+                if(inputBytes < 3 || outputBytes < 3)
+                {
+                    return nullptr;
+                }
+
+                if(inputBytes == 4 && outputBytes == 4 && swapRedBlue && straightInput == straightOutput)
+                {
+                    return shuffleQuadSSSE3;
+                }
+
+                if(inputBytes == 3 && outputBytes == 3 && swapRedBlue)
+                {
+                    return shuffleTripleSSSE3;
+                }
+
+                if(inputBytes == 3 && outputBytes == 4)
+                {
+                    return swapRedBlue ? tripleToQuadSSSE3<true> : tripleToQuadSSSE3<false>;
+                }
+
+                if(inputBytes == 4 && outputBytes == 3 && straightInput)
+                {
+                    return swapRedBlue ? quadToTripleSSSE3<true> : quadToTripleSSSE3<false>;
+                }
+            #endif
+            }
+
+            return nullptr;
+        }
+    } // namespace
+
+    int bytesPerPixel(const pixelFormat& format)
+    {
+        switch(format)
+        {
+            case pixelFormat::GRAY:
+                return 1;
+            case pixelFormat::BGR555:
+            case pixelFormat::BGRA5551:
+                return 2;
+            case pixelFormat::BGR:
+            case pixelFormat::RGB:
+                return 3;
+            default:
+                return 4;
+        }
+    }
+
+    int channelCount(const pixelFormat& format)
+    {
+        switch(format)
+        {
+            case pixelFormat::GRAY:
+                return 1;
+            case pixelFormat::BGR555:
+            case pixelFormat::BGR:
+            case pixelFormat::RGB:
+                return 3;
+            default:
+                return 4;
+        }
+    }
+
+    std::variant<pixelFormat, ErrorCodes> nativePixelFormat(const TGAHeader& header)
+    {
+        const auto isBlackWhite = header.imagetypecode == TYPE_FORMAT::UNCOMPRESSED_BW ||
+                                  header.imagetypecode == TYPE_FORMAT::COMPRESSED_BW;
+
+        switch(header.bitsperpixel>>3)
+        {
+            case 1:
+                return pixelFormat::GRAY;
+            case 2:
+                if(isBlackWhite)
+                {
+                    break;
+                }
+                // The low bits of the image descriptor count the alpha bits of a pixel
+                return (header.imagedescriptor & 0x0F) != 0 ? pixelFormat::BGRA5551 : pixelFormat::BGR555;
+            case 3:
+                return pixelFormat::BGR;
+            case 4:
+                return pixelFormat::BGRA;
+            default:
+                break;
+        }
+
+        return ErrorCodes::UnsupportedFormat;
+    }
+
+    std::optional<ErrorCodes> convertPixelsReference(const std::uint8_t* input, const pixelFormat& inputFormat,
+                                                     std::uint8_t* output, const pixelFormat& outputFormat, const std::size_t& pixelCount)
+    {
+        if(pixelCount != 0 && (input == nullptr || output == nullptr))
+        {
+            return ErrorCodes::InvalidReadOperation;
+        }
+
+        if(inputFormat != outputFormat)
+        {
+            convertScalar(input, inputFormat, output, outputFormat, pixelCount);
+        }
+        else if(input != output)
+        {
+            std::memcpy(output, input, pixelCount*bytesPerPixel(inputFormat));
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> convertPixels(const std::uint8_t* input, const pixelFormat& inputFormat,
+                                            std::uint8_t* output, const pixelFormat& outputFormat, const std::size_t& pixelCount)
+    {
+        if(pixelCount != 0 && (input == nullptr || output == nullptr))
+        {
+            return ErrorCodes::InvalidReadOperation;
+        }
+
+        if(inputFormat == outputFormat)
+        {
+            if(input != output)
+            {
+                std::memcpy(output, input, pixelCount*bytesPerPixel(inputFormat));
+            }
+
+            return std::nullopt;
+        }
+
+        std::size_t converted = 0;
+        if(const auto kernel = selectKernel(inputFormat, outputFormat); kernel != nullptr)
+        {
+            converted = kernel(input, output, pixelCount);
+        }
+
+        convertScalar(input + converted*bytesPerPixel(inputFormat), inputFormat,
+                      output + converted*bytesPerPixel(outputFormat), outputFormat, pixelCount - converted);
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> convertPixels(const ConstImageView& input, const pixelFormat& inputFormat,
+                                            const ImageView& output, const pixelFormat& outputFormat)
+    {
+        if(input.width() != output.width() || input.height() != output.height() ||
+           input.bytesPerPixel() != bytesPerPixel(inputFormat) || output.bytesPerPixel() != bytesPerPixel(outputFormat))
+        {
+            return ErrorCodes::UnsupportedFormat;
+        }
+
+        if(input.empty())
+        {
+            return std::nullopt;
+        }
+
+        // Tightly packed images are converted in one go, so the vectorized kernels are not interrupted at row ends
+        if(input.isContiguous() && output.isContiguous())
+        {
+            return convertPixels(input.data(), inputFormat, output.data(), outputFormat,
+                                 static_cast<std::size_t>(input.width())*input.height());
+        }
+
+        for(auto row = 0; row < input.height(); ++row)
+        {
+            convertPixels(input.row(row), inputFormat, output.row(row), outputFormat, input.width());
+        }
+
+        return std::nullopt;
+    }
+
+    std::variant<TGAImage, ErrorCodes> convertImage(const TGAImage& image, const pixelFormat& format)
+    {
+        const auto header = image.getHeader();
+        const auto nativeFormat = nativePixelFormat(header);
+        if(std::holds_alternative<ErrorCodes>(nativeFormat))
+        {
+            return std::get<ErrorCodes>(nativeFormat);
+        }
+
+        const auto outputBytes = bytesPerPixel(format);
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(image.width())*image.height()*outputBytes);
+
+        auto result = convertPixels(image.constView(), std::get<pixelFormat>(nativeFormat),
+                                    ImageView{pixels.data(), image.width(), image.height(), outputBytes}, format);
+        if(result.has_value())
+        {
+            return result.value();
+        }
+
+        return TGAImage{image.width(), image.height(), outputBytes, formatHeader(header, format), std::move(pixels)};
+    }
+
+    std::optional<ErrorCodes> convertToPlanarFloat(const ConstImageView& input, const pixelFormat& inputFormat,
+                                                   float* output, const pixelFormat& planeFormat)
+    {
+        if(input.bytesPerPixel() != bytesPerPixel(inputFormat) || bytesPerPixel(planeFormat) != channelCount(planeFormat))
+        {
+            return ErrorCodes::UnsupportedFormat;
+        }
+
+        if(input.empty())
+        {
+            return std::nullopt;
+        }
+
+        if(output == nullptr)
+        {
+            return ErrorCodes::InvalidWriteOperation;
+        }
+
+        const auto channels = channelCount(planeFormat);
+        const std::size_t width = input.width();
+        const auto planeSize = width*input.height();
+        constexpr auto scale = 1.0f/255.0f;
+
+        std::vector<std::uint8_t> row(width*channels);
+        for(auto y = 0; y < input.height(); ++y)
+        {
+            convertPixels(input.row(y), inputFormat, row.data(), planeFormat, width);
+
+            for(auto channel = 0; channel < channels; ++channel)
+            {
+                auto plane = output + channel*planeSize + y*width;
+                const auto source = row.data() + channel;
+                for(std::size_t x = 0; x < width; ++x)
+                {
+                    plane[x] = source[x*channels]*scale;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+} // namespace imageloader
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace imageloader
+{
+    // Kernels are compiled for each pixel size up to this one, PixelSize 0 stands for a size only known at runtime
+    constexpr int maxBytesPerPixel = 4;
+
+    template<int PixelSize>
+    using pixelSizeConstant = std::integral_constant<int, PixelSize>;
+
+    // Calls function(pixelSizeConstant<N>) once with N the bytes per pixel if it is 1 to 4 and N = 0 otherwise, so a kernel
+    // written once as a template gets fixed width loads and stores and fully unrolled per pixel loops
+    template<typename Function>
+    decltype(auto) withPixelSize(const int& bytesPerPixel, Function&& function)
+    {
+        switch(bytesPerPixel)
+        {
+        case 1:
+            return function(pixelSizeConstant<1>{});
+        case 2:
+            return function(pixelSizeConstant<2>{});
+        case 3:
+            return function(pixelSizeConstant<3>{});
+        case 4:
+            return function(pixelSizeConstant<4>{});
+        default:
+            return function(pixelSizeConstant<0>{});
+        }
+    }
+
+    // Compile-time pixel size if there is one, the runtime size otherwise
+    template<int PixelSize>
+    constexpr int pixelSize(const int& bytesPerPixel)
+    {
+        return PixelSize != 0 ? PixelSize : bytesPerPixel;
+    }
+
+    template<int PixelSize>
+    void copyPixel(std::uint8_t* output, const std::uint8_t* input, const int& bytesPerPixel)
+    {
+        std::memcpy(output, input, pixelSize<PixelSize>(bytesPerPixel));
+    }
+
+    template<int PixelSize>
+    bool equalPixels(const std::uint8_t* lhs, const std::uint8_t* rhs, const int& bytesPerPixel)
+    {
+        return std::memcmp(lhs, rhs, pixelSize<PixelSize>(bytesPerPixel)) == 0;
+    }
+} // namespace imageloader
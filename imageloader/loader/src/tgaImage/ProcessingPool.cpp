@@ -0,0 +1,10 @@
+#include "ProcessingPool.hpp"
+
+namespace imageloader
+{
+    utils::threading::ThreadPool& processingPool()
+    {
+        static utils::threading::ThreadPool pool{0};
+        return pool;
+    }
+} // namespace imageloader
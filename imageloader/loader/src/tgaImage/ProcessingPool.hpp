@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "ThreadPool.hpp"
+
+namespace imageloader
+{
+    // Images with fewer pixels are processed on the calling thread
+    constexpr std::size_t minParallelPixels = 256*1024;
+
+    // Workers shared by the image processing functions, one per hardware thread, started on first use
+    utils::threading::ThreadPool& processingPool();
+
+    // Calls function(firstRow, bandRows) for bands of rows covering [0, rowCount). Band sizes are multiples of rowAlignment,
+    // bands run on the processing pool if there are at least minParallelPixels pixels.
+    template<typename Function>
+    void forEachBand(const int& rowCount, const std::size_t& rowPixels, const int& rowAlignment, Function&& function)
+    {
+        if(rowCount <= 0)
+        {
+            return;
+        }
+
+        if(static_cast<std::size_t>(rowCount)*rowPixels < minParallelPixels)
+        {
+            function(0, rowCount);
+            return;
+        }
+
+        auto& pool = processingPool();
+        // A few bands per worker, so uneven bands do not leave workers idle
+        const auto bandCount = static_cast<int>(pool.workerCount())*4;
+        const auto alignedRows = ((rowCount + bandCount - 1)/bandCount + rowAlignment - 1)/rowAlignment*rowAlignment;
+        const auto bandRows = std::max(alignedRows, rowAlignment);
+        const auto bands = static_cast<std::size_t>((rowCount + bandRows - 1)/bandRows);
+
+        pool.parallelFor(bands, [&](const std::size_t& band)
+        {
+            const auto firstRow = static_cast<int>(band)*bandRows;
+            function(firstRow, std::min(bandRows, rowCount - firstRow));
+        });
+    }
+} // namespace imageloader
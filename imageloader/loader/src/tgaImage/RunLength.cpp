@@ -0,0 +1,427 @@
+#include "RunLength.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "PixelSize.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define IMAGELOADER_RLE_SSE2
+    #include <emmintrin.h>
+    #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        #define IMAGELOADER_RLE_AVX2
+        #include <immintrin.h>
+    #endif
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#endif
+
+namespace imageloader
+{
+    namespace
+    {
+        // Pixels of a fixed size written one by one before fillPixels switches to copying the filled range
+        constexpr std::size_t storedFillPixels = 16;
+
+        // Writes the first pixels and then doubles the filled range, so long runs end up as a few large memcpy calls
+        template<int PixelSize>
+        void fillPixels(std::uint8_t* output, const std::uint8_t* pixel, const int& bytesPerPixel, const std::size_t& pixelCount)
+        {
+            const std::size_t size = pixelSize<PixelSize>(bytesPerPixel);
+            if(size == 1)
+            {
+                std::memset(output, pixel[0], pixelCount);
+                return;
+            }
+
+            const auto totalBytes = pixelCount*size;
+            std::size_t filledBytes = size;
+            if constexpr(PixelSize != 0)
+            {
+                const auto storedPixels = std::min(pixelCount, storedFillPixels);
+                for(std::size_t index = 0; index < storedPixels; ++index)
+                {
+                    copyPixel<PixelSize>(output + index*PixelSize, pixel, PixelSize);
+                }
+                filledBytes = storedPixels*PixelSize;
+            }
+            else
+            {
+                std::memcpy(output, pixel, size);
+            }
+
+            while(filledBytes < totalBytes)
+            {
+                const auto chunk = std::min(filledBytes, totalBytes - filledBytes);
+                std::memcpy(output + filledBytes, output, chunk);
+                filledBytes += chunk;
+            }
+        }
+
+        unsigned int countTrailingZeros(const unsigned int& value)
+        {
+        #if defined(_MSC_VER)
+            unsigned long index{};
+            _BitScanForward(&index, value);
+            return index;
+        #else
+            return __builtin_ctz(value);
+        #endif
+        }
+
+        // Bits of a byte compare mask that start a pixel, one entry per bytes per pixel
+        constexpr std::uint32_t pixelStartMask[] = {0, 0xFFFFFFFF, 0x55555555, 0x09249249, 0x11111111};
+
+        // Reduces a byte compare mask to a mask with bits set only at starts of fully equal pixels
+        template<int PixelSize>
+        unsigned int equalPixelMask(unsigned int byteMask, const int& bytesPerPixel, const unsigned int& pixelMask)
+        {
+            auto result = byteMask;
+            for(auto iter = 1; iter < pixelSize<PixelSize>(bytesPerPixel); ++iter)
+            {
+                result &= byteMask >> iter;
+            }
+
+            return result & pixelMask;
+        }
+
+        std::size_t equalPrefixScalar(const std::uint8_t* lhs, const std::uint8_t* rhs, const std::size_t& length)
+        {
+            std::size_t index = 0;
+            while(index < length && lhs[index] == rhs[index])
+            {
+                ++index;
+            }
+
+            return index;
+        }
+
+        template<int PixelSize>
+        std::size_t findEqualNeighbourScalar(const std::uint8_t* data, const int& bytesPerPixel, std::size_t first, const std::size_t& last)
+        {
+            const auto size = pixelSize<PixelSize>(bytesPerPixel);
+            for(; first < last; ++first)
+            {
+                const auto pixel = data + first*size;
+                if(equalPixels<PixelSize>(pixel, pixel + size, size))
+                {
+                    return first;
+                }
+            }
+
+            return last;
+        }
+
+    #if defined(IMAGELOADER_RLE_SSE2)
+        std::size_t equalPrefixSSE2(const std::uint8_t* lhs, const std::uint8_t* rhs, const std::size_t& length)
+        {
+            std::size_t index = 0;
+            for(; index + 16 <= length; index += 16)
+            {
+                const auto left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + index));
+                const auto right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + index));
+                const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(left, right)));
+                if(mask != 0xFFFF)
+                {
+                    return index + countTrailingZeros(~mask);
+                }
+            }
+
+            return index + equalPrefixScalar(lhs + index, rhs + index, length - index);
+        }
+
+        template<int PixelSize>
+        std::size_t findEqualNeighbourSSE2(const std::uint8_t* data, const int& bytesPerPixel, std::size_t first, const std::size_t& last)
+        {
+            const auto size = pixelSize<PixelSize>(bytesPerPixel);
+            const std::size_t pixelsPerStep = 16/size;
+            const auto pixelMask = pixelStartMask[size] & 0xFFFF;
+
+            // Both loads have to end before the end of pixel `last`
+            while((first + 1)*size + 16 <= (last + 1)*size)
+            {
+                const auto pixel = data + first*size;
+                const auto current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixel));
+                const auto next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixel + size));
+                const auto byteMask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(current, next)));
+                const auto mask = equalPixelMask<PixelSize>(byteMask, size, pixelMask);
+                if(mask != 0)
+                {
+                    return first + countTrailingZeros(mask)/size;
+                }
+                first += pixelsPerStep;
+            }
+
+            return findEqualNeighbourScalar<PixelSize>(data, size, first, last);
+        }
+    #endif
+
+    #if defined(IMAGELOADER_RLE_AVX2)
+        __attribute__((target("avx2")))
+        std::size_t equalPrefixAVX2(const std::uint8_t* lhs, const std::uint8_t* rhs, const std::size_t& length)
+        {
+            std::size_t index = 0;
+            for(; index + 32 <= length; index += 32)
+            {
+                const auto left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + index));
+                const auto right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + index));
+                const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(left, right)));
+                if(mask != 0xFFFFFFFF)
+                {
+                    return index + countTrailingZeros(~mask);
+                }
+            }
+
+            // GCC calls the SSE2 kernels without leaving the AVX state first, every legacy SSE instruction
+            // afterwards would pay for the transition
+            _mm256_zeroupper();
+            return index + equalPrefixSSE2(lhs + index, rhs + index, length - index);
+        }
+
+        template<int PixelSize>
+        __attribute__((target("avx2")))
+        std::size_t findEqualNeighbourAVX2(const std::uint8_t* data, const int& bytesPerPixel, std::size_t first, const std::size_t& last)
+        {
+            const auto size = pixelSize<PixelSize>(bytesPerPixel);
+            const std::size_t pixelsPerStep = 32/size;
+            const auto pixelMask = pixelStartMask[size];
+
+            while((first + 1)*size + 32 <= (last + 1)*size)
+            {
+                const auto pixel = data + first*size;
+                const auto current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixel));
+                const auto next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixel + size));
+                const auto byteMask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(current, next)));
+                const auto mask = equalPixelMask<PixelSize>(byteMask, size, pixelMask);
+                if(mask != 0)
+                {
+                    return first + countTrailingZeros(mask)/size;
+                }
+                first += pixelsPerStep;
+            }
+
+            _mm256_zeroupper();
+            return findEqualNeighbourSSE2<PixelSize>(data, size, first, last);
+        }
+    #endif
+
+        using FindEqualNeighbour = std::size_t (*)(const std::uint8_t*, const int&, std::size_t, const std::size_t&);
+
+        struct CompareKernels
+        {
+            // Number of leading bytes that are equal in both ranges
+            std::size_t (*equalPrefix)(const std::uint8_t*, const std::uint8_t*, const std::size_t&);
+            // First pixel in [first, last) that equals its successor, or last. Indexed by pixel size, the SIMD
+            // kernels take pixels of at most maxBytesPerPixel bytes.
+            std::array<FindEqualNeighbour, maxBytesPerPixel + 1> findEqualNeighbour;
+        };
+
+        CompareKernels selectCompareKernels()
+        {
+        #if defined(IMAGELOADER_RLE_AVX2)
+            if(__builtin_cpu_supports("avx2"))
+            {
+                return {equalPrefixAVX2, {findEqualNeighbourAVX2<0>, findEqualNeighbourAVX2<1>, findEqualNeighbourAVX2<2>,
+                                          findEqualNeighbourAVX2<3>, findEqualNeighbourAVX2<4>}};
+            }
+        #endif
+        #if defined(IMAGELOADER_RLE_SSE2)
+            return {equalPrefixSSE2, {findEqualNeighbourSSE2<0>, findEqualNeighbourSSE2<1>, findEqualNeighbourSSE2<2>,
+                                      findEqualNeighbourSSE2<3>, findEqualNeighbourSSE2<4>}};
+        #else
+            return {equalPrefixScalar, {findEqualNeighbourScalar<0>, findEqualNeighbourScalar<1>, findEqualNeighbourScalar<2>,
+                                        findEqualNeighbourScalar<3>, findEqualNeighbourScalar<4>}};
+        #endif
+        }
+
+        const CompareKernels& compareKernels()
+        {
+            static const CompareKernels kernels = selectCompareKernels();
+            return kernels;
+        }
+    } // namespace
+
+    RunLengthDecoder::RunLengthDecoder(const int& bytesPerPixel, const std::size_t& pixelCount) :
+                                        kernel{withPixelSize(bytesPerPixel, [](auto size) -> Kernel
+                                               { return &RunLengthDecoder::decodePixels<decltype(size)::value>; })},
+                                        bytesPerPixel{bytesPerPixel},
+                                        unassignedPixels{pixelCount},
+                                        pendingOutputBytes{pixelCount*bytesPerPixel}
+    {
+
+    }
+
+    std::optional<ErrorCodes> RunLengthDecoder::decode(const std::uint8_t*& input, const std::uint8_t* inputEnd,
+                                                       std::uint8_t*& output, std::uint8_t* outputEnd)
+    {
+        return (this->*kernel)(input, inputEnd, output, outputEnd);
+    }
+
+    template<int PixelSize>
+    std::optional<ErrorCodes> RunLengthDecoder::decodePixels(const std::uint8_t*& input, const std::uint8_t* inputEnd,
+                                                             std::uint8_t*& output, std::uint8_t* outputEnd)
+    {
+        const std::size_t size = pixelSize<PixelSize>(bytesPerPixel);
+        while(output < outputEnd)
+        {
+            if(packetRemaining == 0)
+            {
+                if(input == inputEnd)
+                {
+                    return std::nullopt;
+                }
+
+                const auto chunkHeader = *input++;
+                const std::size_t packetPixels = (chunkHeader & maxDataLenghtRLE) + 1;
+                if(packetPixels > unassignedPixels)
+                {
+                    return ErrorCodes::InvalidReadOperation;
+                }
+
+                unassignedPixels -= packetPixels;
+                ++packets;
+                isRunPacket = (chunkHeader & runLengthMask) != 0;
+                packetRemaining = isRunPacket ? packetPixels : packetPixels*size;
+                runPixelBytes = 0;
+
+                if(isRunPacket && size > runPixel.size())
+                {
+                    return ErrorCodes::InvalidReadOperation;
+                }
+            }
+
+            if(!isRunPacket)
+            {
+                //RAW packet, copy as much of it as both buffers allow in one go
+                const auto bytes = std::min({packetRemaining,
+                                             static_cast<std::size_t>(inputEnd - input),
+                                             static_cast<std::size_t>(outputEnd - output)});
+                if(bytes == 0)
+                {
+                    return std::nullopt;
+                }
+
+                std::memcpy(output, input, bytes);
+                input += bytes;
+                output += bytes;
+                packetRemaining -= bytes;
+                pendingOutputBytes -= bytes;
+                continue;
+            }
+
+            //RLE packet, the pixel value may be split between two input blocks
+            if(runPixelBytes == 0 && static_cast<std::size_t>(inputEnd - input) >= size)
+            {
+                copyPixel<PixelSize>(runPixel.data(), input, bytesPerPixel);
+                input += size;
+                runPixelBytes = bytesPerPixel;
+            }
+
+            while(runPixelBytes < bytesPerPixel && input < inputEnd)
+            {
+                runPixel[runPixelBytes++] = *input++;
+            }
+
+            if(runPixelBytes < bytesPerPixel)
+            {
+                return std::nullopt;
+            }
+
+            const auto pixels = std::min(packetRemaining, static_cast<std::size_t>(outputEnd - output)/size);
+            if(pixels == 0)
+            {
+                // Output boundaries are expected to be pixel aligned
+                return ErrorCodes::InvalidReadOperation;
+            }
+
+            fillPixels<PixelSize>(output, runPixel.data(), bytesPerPixel, pixels);
+            output += pixels*size;
+            packetRemaining -= pixels;
+            pendingOutputBytes -= pixels*size;
+        }
+
+        return std::nullopt;
+    }
+
+    template std::optional<ErrorCodes> RunLengthDecoder::decodePixels<0>(const std::uint8_t*&, const std::uint8_t*, std::uint8_t*&, std::uint8_t*);
+    template std::optional<ErrorCodes> RunLengthDecoder::decodePixels<1>(const std::uint8_t*&, const std::uint8_t*, std::uint8_t*&, std::uint8_t*);
+    template std::optional<ErrorCodes> RunLengthDecoder::decodePixels<2>(const std::uint8_t*&, const std::uint8_t*, std::uint8_t*&, std::uint8_t*);
+    template std::optional<ErrorCodes> RunLengthDecoder::decodePixels<3>(const std::uint8_t*&, const std::uint8_t*, std::uint8_t*&, std::uint8_t*);
+    template std::optional<ErrorCodes> RunLengthDecoder::decodePixels<4>(const std::uint8_t*&, const std::uint8_t*, std::uint8_t*&, std::uint8_t*);
+
+    bool RunLengthDecoder::finished() const
+    {
+        return pendingOutputBytes == 0;
+    }
+
+    std::size_t RunLengthDecoder::packetCount() const
+    {
+        return packets;
+    }
+
+    RunLengthEncoder::RunLengthEncoder(const int& bytesPerPixel) :
+                                        kernel{withPixelSize(bytesPerPixel, [](auto size) -> Kernel
+                                               { return &RunLengthEncoder::encodePixels<decltype(size)::value>; })},
+                                        bytesPerPixel{bytesPerPixel}
+    {
+
+    }
+
+    std::size_t RunLengthEncoder::encode(const std::uint8_t* data, const std::size_t& pixelCount, std::size_t currentPixel,
+                                         std::vector<std::uint8_t>& output, const std::size_t& outputLimit)
+    {
+        return (this->*kernel)(data, pixelCount, currentPixel, output, outputLimit);
+    }
+
+    template<int PixelSize>
+    std::size_t RunLengthEncoder::encodePixels(const std::uint8_t* data, const std::size_t& pixelCount, std::size_t currentPixel,
+                                               std::vector<std::uint8_t>& output, const std::size_t& outputLimit)
+    {
+        const auto& kernels = compareKernels();
+        const std::size_t size = pixelSize<PixelSize>(bytesPerPixel);
+        const auto findEqualNeighbour = size <= maxBytesPerPixel ? kernels.findEqualNeighbour[PixelSize]
+                                                                 : findEqualNeighbourScalar<PixelSize>;
+
+        while(currentPixel < pixelCount && output.size() < outputLimit)
+        {
+            const auto chunkStart = data + currentPixel*size;
+            const auto chunkLimit = std::min<std::size_t>(maxChunkLength, pixelCount - currentPixel);
+            std::size_t runLengthNumber = 1;
+
+            if(chunkLimit > 1)
+            {
+                isChunkRaw = !equalPixels<PixelSize>(chunkStart, chunkStart + size, bytesPerPixel);
+                if(isChunkRaw)
+                {
+                    // RAW chunk ends right before the first pixel that starts a run
+                    const auto last = currentPixel + chunkLimit - 1;
+                    const auto runStart = findEqualNeighbour(data, bytesPerPixel, currentPixel + 1, last);
+                    runLengthNumber = runStart == last ? chunkLimit : runStart - currentPixel;
+                }
+                else
+                {
+                    const auto equalBytes = kernels.equalPrefix(chunkStart, chunkStart + size, (chunkLimit - 1)*size);
+                    runLengthNumber = equalBytes/size + 1;
+                }
+            }
+
+            const auto chunkStatusValue = isChunkRaw ? runLengthNumber - 1 : runLengthNumber + maxDataLenghtRLE;
+            output.push_back(static_cast<std::uint8_t>(chunkStatusValue));
+
+            //In case of a RAW data, write bigger chunk, as size number of raw chunks * bytesPerPixel
+            const auto dataToBeWriten = isChunkRaw ? runLengthNumber*size : size;
+            output.insert(output.end(), chunkStart, chunkStart + dataToBeWriten);
+
+            currentPixel += runLengthNumber;
+        }
+
+        return currentPixel;
+    }
+
+    template std::size_t RunLengthEncoder::encodePixels<0>(const std::uint8_t*, const std::size_t&, std::size_t, std::vector<std::uint8_t>&, const std::size_t&);
+    template std::size_t RunLengthEncoder::encodePixels<1>(const std::uint8_t*, const std::size_t&, std::size_t, std::vector<std::uint8_t>&, const std::size_t&);
+    template std::size_t RunLengthEncoder::encodePixels<2>(const std::uint8_t*, const std::size_t&, std::size_t, std::vector<std::uint8_t>&, const std::size_t&);
+    template std::size_t RunLengthEncoder::encodePixels<3>(const std::uint8_t*, const std::size_t&, std::size_t, std::vector<std::uint8_t>&, const std::size_t&);
+    template std::size_t RunLengthEncoder::encodePixels<4>(const std::uint8_t*, const std::size_t&, std::size_t, std::vector<std::uint8_t>&, const std::size_t&);
+} // namespace imageloader
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "ErrorCodes.hpp"
+
+namespace imageloader
+{
+    constexpr auto maxChunkLength = 128;
+    constexpr auto maxDataLenghtRLE = 127;
+    constexpr auto runLengthMask = 0x80;
+
+    // Resumable TGA RLE decoder. Input may be fed in blocks of arbitrary size and output may be requested
+    // in pieces of whole pixels (e.g. row by row), packets crossing either boundary are carried over.
+    class RunLengthDecoder
+    {
+        public:
+            RunLengthDecoder(const int& bytesPerPixel, const std::size_t& pixelCount);
+
+            // Decodes until the input is consumed or the output is full, both pointers are advanced.
+            // Fails if a packet would produce more than pixelCount pixels in total.
+            std::optional<ErrorCodes> decode(const std::uint8_t*& input, const std::uint8_t* inputEnd,
+                                             std::uint8_t*& output, std::uint8_t* outputEnd);
+
+            // decode() compiled for pixels of PixelSize bytes, 0 takes any size. decode() uses the one matching
+            // bytesPerPixel, chosen at construction.
+            template<int PixelSize>
+            std::optional<ErrorCodes> decodePixels(const std::uint8_t*& input, const std::uint8_t* inputEnd,
+                                                   std::uint8_t*& output, std::uint8_t* outputEnd);
+
+            // True once all pixelCount pixels were written
+            bool finished() const;
+            // Packet headers read so far
+            std::size_t packetCount() const;
+
+        private:
+            using Kernel = std::optional<ErrorCodes> (RunLengthDecoder::*)(const std::uint8_t*&, const std::uint8_t*,
+                                                                           std::uint8_t*&, std::uint8_t*);
+
+            Kernel kernel{nullptr};
+            int bytesPerPixel{0};
+            // Pixels not yet covered by any packet header
+            std::size_t unassignedPixels{0};
+            std::size_t pendingOutputBytes{0};
+            std::size_t packets{0};
+
+            bool isRunPacket{false};
+            // Raw packet: bytes still to be copied, run packet: pixels still to be filled
+            std::size_t packetRemaining{0};
+            std::array<std::uint8_t, 4> runPixel{};
+            int runPixelBytes{0};
+    };
+
+    // TGA RLE encoder producing the same packets as the original byte by byte encoder. Runs of equal pixels
+    // are searched with SSE2/AVX2 compares where available, packets are appended to a caller owned buffer.
+    class RunLengthEncoder
+    {
+        public:
+            explicit RunLengthEncoder(const int& bytesPerPixel);
+
+            // Encodes packets starting at currentPixel until all pixelCount pixels are encoded or output holds
+            // at least outputLimit bytes. Returns the first pixel that is not encoded yet, so the caller can
+            // flush the buffer and continue without breaking the packet sequence.
+            std::size_t encode(const std::uint8_t* data, const std::size_t& pixelCount, std::size_t currentPixel,
+                               std::vector<std::uint8_t>& output, const std::size_t& outputLimit);
+
+            // encode() compiled for pixels of PixelSize bytes, 0 takes any size
+            template<int PixelSize>
+            std::size_t encodePixels(const std::uint8_t* data, const std::size_t& pixelCount, std::size_t currentPixel,
+                                     std::vector<std::uint8_t>& output, const std::size_t& outputLimit);
+
+        private:
+            using Kernel = std::size_t (RunLengthEncoder::*)(const std::uint8_t*, const std::size_t&, std::size_t,
+                                                             std::vector<std::uint8_t>&, const std::size_t&);
+
+            Kernel kernel{nullptr};
+            int bytesPerPixel{0};
+            // A lone trailing pixel is stored with the packet type of the previous packet
+            bool isChunkRaw{true};
+    };
+} // namespace imageloader
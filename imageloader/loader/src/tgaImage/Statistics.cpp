@@ -0,0 +1,256 @@
+#include "tgaImage/Statistics.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+#include "ProcessingPool.hpp"
+
+namespace imageloader
+{
+    namespace
+    {
+        constexpr int tableCount = 4;
+        constexpr int tableChannels = 4;
+        constexpr std::size_t tableSize = 256;
+        // 16 bit pixels are expanded to BGRA in blocks of this many pixels before they are counted
+        constexpr std::size_t expandBlockPixels = 256;
+        // Counters of the interleaved tables are moved to the 64 bit totals before they can overflow
+        constexpr std::size_t maxPendingPixels = std::numeric_limits<std::uint32_t>::max();
+
+        bool hasAlphaChannel(const pixelFormat& format)
+        {
+            return channelCount(format) == 4;
+        }
+
+        std::uint32_t* tableOf(std::uint32_t* tables, const int& table, const int& channel)
+        {
+            return tables + (static_cast<std::size_t>(table)*tableChannels + channel)*tableSize;
+        }
+
+        template<int channels, int pixelSize = channels>
+        void countPixels(std::uint32_t* tables, const std::uint8_t* pixels, const std::size_t& pixelCount)
+        {
+            std::uint32_t* counters[tableCount][channels];
+            for(auto table = 0; table < tableCount; ++table)
+            {
+                for(auto channel = 0; channel < channels; ++channel)
+                {
+                    counters[table][channel] = tableOf(tables, table, channel);
+                }
+            }
+
+            std::size_t index = 0;
+            for(; index + tableCount <= pixelCount; index += tableCount, pixels += tableCount*pixelSize)
+            {
+                for(auto table = 0; table < tableCount; ++table)
+                {
+                    for(auto channel = 0; channel < channels; ++channel)
+                    {
+                        ++counters[table][channel][pixels[table*pixelSize + channel]];
+                    }
+                }
+            }
+
+            for(; index < pixelCount; ++index, pixels += pixelSize)
+            {
+                for(auto channel = 0; channel < channels; ++channel)
+                {
+                    ++counters[0][channel][pixels[channel]];
+                }
+            }
+        }
+    } // namespace
+
+    StatisticsAccumulator::StatisticsAccumulator(const pixelFormat& format) :
+                        pixelsFormat{format},
+                        channels{channelCount(format)},
+                        tables(tableCount*tableChannels*tableSize, 0),
+                        totals(tableChannels*tableSize, 0)
+    {
+
+    }
+
+    void StatisticsAccumulator::add(const std::uint8_t* pixels, const std::size_t& pixelCount)
+    {
+        const auto pixelSize = static_cast<std::size_t>(bytesPerPixel(pixelsFormat));
+
+        for(std::size_t first = 0; first < pixelCount;)
+        {
+            if(pendingPixels == maxPendingPixels)
+            {
+                flush();
+            }
+
+            const auto count = std::min(pixelCount - first, maxPendingPixels - pendingPixels);
+            const auto input = pixels + first*pixelSize;
+
+            switch(pixelsFormat)
+            {
+                case pixelFormat::GRAY:
+                    countPixels<1>(tables.data(), input, count);
+                    break;
+                case pixelFormat::BGR:
+                case pixelFormat::RGB:
+                    countPixels<3>(tables.data(), input, count);
+                    break;
+                case pixelFormat::BGR555:
+                case pixelFormat::BGRA5551:
+                {
+                    // The vectorized conversion expands the 5 bit channels, the unused alpha byte of BGR555 is skipped
+                    std::uint8_t expanded[expandBlockPixels*4];
+                    for(std::size_t block = 0; block < count; block += expandBlockPixels)
+                    {
+                        const auto blockPixels = std::min(expandBlockPixels, count - block);
+                        convertPixels(input + block*pixelSize, pixelsFormat, expanded, pixelFormat::BGRA, blockPixels);
+                        if(pixelFormat::BGR555 == pixelsFormat)
+                        {
+                            countPixels<3, 4>(tables.data(), expanded, blockPixels);
+                        }
+                        else
+                        {
+                            countPixels<4>(tables.data(), expanded, blockPixels);
+                        }
+                    }
+                    break;
+                }
+                default:
+                    countPixels<4>(tables.data(), input, count);
+                    break;
+            }
+
+            pendingPixels += count;
+            first += count;
+        }
+    }
+
+    void StatisticsAccumulator::flush()
+    {
+        for(auto table = 0; table < tableCount; ++table)
+        {
+            for(std::size_t counter = 0; counter < tableChannels*tableSize; ++counter)
+            {
+                totals[counter] += tables[table*tableChannels*tableSize + counter];
+            }
+        }
+
+        std::fill(tables.begin(), tables.end(), 0);
+        pixelCount += pendingPixels;
+        pendingPixels = 0;
+    }
+
+    void StatisticsAccumulator::merge(const StatisticsAccumulator& other)
+    {
+        for(auto table = 0; table < tableCount; ++table)
+        {
+            for(std::size_t counter = 0; counter < tableChannels*tableSize; ++counter)
+            {
+                totals[counter] += other.tables[table*tableChannels*tableSize + counter];
+            }
+        }
+
+        for(std::size_t counter = 0; counter < tableChannels*tableSize; ++counter)
+        {
+            totals[counter] += other.totals[counter];
+        }
+
+        pixelCount += other.pixelCount + other.pendingPixels;
+    }
+
+    const pixelFormat& StatisticsAccumulator::format() const
+    {
+        return pixelsFormat;
+    }
+
+    ImageStatistics StatisticsAccumulator::statistics() const
+    {
+        ImageStatistics result;
+        result.pixelCount = pixelCount + pendingPixels;
+        result.channels.resize(channels);
+        result.hasAlpha = hasAlphaChannel(pixelsFormat);
+
+        for(auto channel = 0; channel < channels; ++channel)
+        {
+            auto& statistics = result.channels[channel];
+            std::uint64_t sum = 0;
+            double squareSum = 0.0;
+
+            for(std::size_t value = 0; value < tableSize; ++value)
+            {
+                auto count = totals[channel*tableSize + value];
+                for(auto table = 0; table < tableCount; ++table)
+                {
+                    count += tables[(static_cast<std::size_t>(table)*tableChannels + channel)*tableSize + value];
+                }
+
+                statistics.histogram[value] = count;
+                sum += count*value;
+                squareSum += static_cast<double>(count)*static_cast<double>(value*value);
+            }
+
+            if(result.pixelCount == 0)
+            {
+                continue;
+            }
+
+            const auto first = std::find_if(statistics.histogram.begin(), statistics.histogram.end(), [](const std::uint64_t& count){ return count != 0; });
+            const auto last = std::find_if(statistics.histogram.rbegin(), statistics.histogram.rend(), [](const std::uint64_t& count){ return count != 0; });
+            statistics.minimum = static_cast<std::uint8_t>(first - statistics.histogram.begin());
+            statistics.maximum = static_cast<std::uint8_t>(statistics.histogram.rend() - last - 1);
+
+            const auto pixels = static_cast<double>(result.pixelCount);
+            statistics.mean = static_cast<double>(sum)/pixels;
+            statistics.variance = std::max(0.0, squareSum/pixels - statistics.mean*statistics.mean);
+        }
+
+        if(result.hasAlpha)
+        {
+            const auto& alpha = result.channels.back();
+            result.alphaCoverage = result.pixelCount != 0 ? alpha.mean/255.0 : 1.0;
+            result.transparentPixels = alpha.histogram.front();
+            result.opaquePixels = alpha.histogram.back();
+        }
+        else
+        {
+            result.opaquePixels = result.pixelCount;
+        }
+
+        return result;
+    }
+
+    std::variant<ImageStatistics, ErrorCodes> computeStatistics(const ConstImageView& image, const pixelFormat& format)
+    {
+        if(image.bytesPerPixel() != bytesPerPixel(format))
+        {
+            return ErrorCodes::UnsupportedFormat;
+        }
+
+        StatisticsAccumulator total{format};
+        std::mutex mutex;
+
+        forEachBand(image.height(), static_cast<std::size_t>(image.width()), 1, [&](const int& firstRow, const int& rowCount)
+        {
+            StatisticsAccumulator band{format};
+            for(auto y = firstRow; y < firstRow + rowCount; ++y)
+            {
+                band.add(image.row(y), static_cast<std::size_t>(image.width()));
+            }
+
+            std::lock_guard<std::mutex> lock{mutex};
+            total.merge(band);
+        });
+
+        return total.statistics();
+    }
+
+    std::variant<ImageStatistics, ErrorCodes> computeStatistics(const TGAImage& image)
+    {
+        const auto format = nativePixelFormat(image.getHeader());
+        if(std::holds_alternative<ErrorCodes>(format))
+        {
+            return std::get<ErrorCodes>(format);
+        }
+
+        return computeStatistics(image.constView(), std::get<pixelFormat>(format));
+    }
+} // namespace imageloader
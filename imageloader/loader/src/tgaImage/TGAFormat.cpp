@@ -0,0 +1,114 @@
+#include "TGAFormat.hpp"
+
+#include <cstring>
+
+#include "PixelSize.hpp"
+
+namespace imageloader
+{
+    bool isCompressedFormat(const TGAHeader& header)
+    {
+        return header.imagetypecode == TYPE_FORMAT::COMPRESSED_RGB ||
+               header.imagetypecode == TYPE_FORMAT::COMPRESSED_BW;
+    }
+
+    bool isUncompressedFormat(const TGAHeader& header)
+    {
+        return header.imagetypecode == TYPE_FORMAT::UNCOMPRESSED_RGB ||
+               header.imagetypecode == TYPE_FORMAT::UNCOMPRESSED_BW;
+    }
+
+    bool isSupportedPixelSize(const TGAHeader& header)
+    {
+        const auto bytesPerPixel = header.bitsperpixel>>3;
+        return bytesPerPixel >= 1 && bytesPerPixel <= maxBytesPerPixel;
+    }
+
+    std::size_t pixelDataOffset(const TGAHeader& header)
+    {
+        const std::size_t colorMapBytes = header.colormaptype != 0 ? header.colormaplength*((header.colormapsize + 7)>>3) : 0;
+        return sizeof(TGAHeader) + header.idlenght + colorMapBytes;
+    }
+
+    std::variant<TGAHeader, ErrorCodes> parseHeader(const std::uint8_t* data, const std::size_t& size)
+    {
+        if(data == nullptr || size < sizeof(TGAHeader))
+        {
+            return ErrorCodes::InvalidReadOperation;
+        }
+
+        TGAHeader header{};
+        std::memcpy(&header, data, sizeof(header));
+
+        if(pixelDataOffset(header) > size)
+        {
+            return ErrorCodes::InvalidReadOperation;
+        }
+
+        return header;
+    }
+
+    bool parseFooter(const std::uint8_t* footer, std::uint32_t& extensionOffset, std::uint32_t& developerOffset)
+    {
+        // The signature is stored including its terminating zero
+        if(std::memcmp(footer + 8, footerSignature, sizeof(footerSignature)) != 0)
+        {
+            return false;
+        }
+
+        std::memcpy(&extensionOffset, footer, sizeof(extensionOffset));
+        std::memcpy(&developerOffset, footer + 4, sizeof(developerOffset));
+        return true;
+    }
+
+    TGAHeader storedHeader(TGAHeader header, const bool& isCompressed)
+    {
+        const auto isBlackWhite = header.imagetypecode == TYPE_FORMAT::UNCOMPRESSED_BW ||
+                                  header.imagetypecode == TYPE_FORMAT::COMPRESSED_BW;
+
+        if(isCompressed)
+        {
+            header.imagetypecode = isBlackWhite ? TYPE_FORMAT::COMPRESSED_BW : TYPE_FORMAT::COMPRESSED_RGB;
+        }
+        else
+        {
+            header.imagetypecode = isBlackWhite ? TYPE_FORMAT::UNCOMPRESSED_BW : TYPE_FORMAT::UNCOMPRESSED_RGB;
+        }
+        header.idlenght = 0;
+        // No color map is written for true-color and black-white images, a stale field would shift the pixel data on reload
+        header.colormaptype = 0;
+        header.colormaporigin = 0;
+        header.colormaplength = 0;
+        header.colormapsize = 0;
+
+        return header;
+    }
+
+    TGAHeader formatHeader(TGAHeader header, const pixelFormat& format)
+    {
+        const auto isGray = format == pixelFormat::GRAY;
+        if(isCompressedFormat(header))
+        {
+            header.imagetypecode = isGray ? TYPE_FORMAT::COMPRESSED_BW : TYPE_FORMAT::COMPRESSED_RGB;
+        }
+        else
+        {
+            header.imagetypecode = isGray ? TYPE_FORMAT::UNCOMPRESSED_BW : TYPE_FORMAT::UNCOMPRESSED_RGB;
+        }
+
+        std::uint8_t alphaBits = 0;
+        if(format == pixelFormat::BGRA5551)
+        {
+            alphaBits = 1;
+        }
+        else if(channelCount(format) == 4)
+        {
+            alphaBits = 8;
+        }
+
+        header.bitsperpixel = static_cast<std::uint8_t>(bytesPerPixel(format)*8);
+        header.imagedescriptor = static_cast<std::uint8_t>((header.imagedescriptor & 0xF0) | alphaBits);
+
+        return header;
+    }
+} // namespace imageloader
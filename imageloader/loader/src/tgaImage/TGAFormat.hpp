@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+
+#include "ErrorCodes.hpp"
+#include "tgaImage/PixelFormat.hpp"
+#include "tgaImage/TGAImage.hpp"
+
+namespace imageloader
+{
+    enum TYPE_FORMAT : std::uint8_t
+    {
+        UNCOMPRESSED_RGB = 2,
+        UNCOMPRESSED_BW = 3,
+        COMPRESSED_RGB = 10,
+        COMPRESSED_BW = 11
+    };
+
+    // Bits of TGAHeader::imagedescriptor describing where the first stored pixel is
+    constexpr std::uint8_t rightOriginMask = 0x10;
+    constexpr std::uint8_t topOriginMask = 0x20;
+
+    // TGA 2.0 files end with extension area offset, developer area offset and this signature
+    constexpr std::size_t footerSize = 26;
+    constexpr char footerSignature[] = "TRUEVISION-XFILE.";
+
+    bool isCompressedFormat(const TGAHeader& header);
+    bool isUncompressedFormat(const TGAHeader& header);
+    // Pixels of 1 to 4 bytes, the only sizes the codec and pixel kernels handle
+    bool isSupportedPixelSize(const TGAHeader& header);
+
+    // Pixel data follows the header, image ID field and color map
+    std::size_t pixelDataOffset(const TGAHeader& header);
+
+    std::variant<TGAHeader, ErrorCodes> parseHeader(const std::uint8_t* data, const std::size_t& size);
+
+    // footer holds the last footerSize bytes of a file, false if they are not a TGA 2.0 footer
+    bool parseFooter(const std::uint8_t* footer, std::uint32_t& extensionOffset, std::uint32_t& developerOffset);
+
+    // Header as it is written to a file: image type matches the stored encoding, ID field and color map are not preserved
+    TGAHeader storedHeader(TGAHeader header, const bool& isCompressed);
+
+    // Header of an image converted to format: image type, bits per pixel and alpha bits follow the format
+    TGAHeader formatHeader(TGAHeader header, const pixelFormat& format);
+} // namespace imageloader
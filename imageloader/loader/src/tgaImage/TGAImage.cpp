@@ -1,6 +1,13 @@
 #include "tgaImage/TGAImage.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <mutex>
+
+#include "tgaImage/Geometry.hpp"
+#include "Orientation.hpp"
+#include "PixelSize.hpp"
+#include "TGAFormat.hpp"
 
 namespace imageloader
 {
@@ -11,9 +18,11 @@ TGAColor::TGAColor(const std::uint8_t& r, const std::uint8_t& g, const std::uint
 
 }
 
-TGAColor::TGAColor(const std::uint8_t* channels, const std::uint8_t& bpp)
+TGAColor::TGAColor(const std::uint8_t* channels, const std::uint8_t& bpp) :
+                        bpp{bpp}
 {
-    for(int iter = bpp; iter < 0; --iter)
+    const auto channelCount = std::min<int>(bpp, imageloader::tgaimage::constants::NUM_OF_CHANNELS);
+    for(int iter = 0; iter < channelCount; ++iter)
     {
         bgra[iter] = channels[iter];
     }
@@ -34,23 +43,177 @@ std::uint8_t& TGAColor::operator[](const int& index)
     return bgra[index];
 }
 
+    // Decoder of a lazy image and what it produced, shared by all const accessors
+    struct LazyPixels
+    {
+        std::once_flag decoded;
+        PixelDecoder decoder;
+        std::unique_ptr<TGAImage> image;
+        std::optional<ErrorCodes> error;
+    };
+
     class TGAImageImpl
     {
         public:
+            TGAImageImpl() = default;
+
+            // A lazy source is decoded first, the copy owns its pixels and is not lazy
+            TGAImageImpl(const TGAImageImpl& rhs) :
+                        width{rhs.width},
+                        height{rhs.height},
+                        image{rhs.image},
+                        buffer{rhs.buffer},
+                        imageView{rhs.imageView},
+                        viewSize{rhs.viewSize},
+                        bpp{rhs.bpp},
+                        header{rhs.header},
+                        error{rhs.decodeError()}
+            {
+                if(rhs.lazy)
+                {
+                    image.assign(rhs.pixels(), rhs.pixels() + rhs.size());
+                }
+            }
+
+            TGAImageImpl& operator=(const TGAImageImpl&) = delete;
+
             int width{0};
             int height{0};
-            std::vector<std::uint8_t> image{0};
+            // Exactly one of the storages is in use: owned vector, allocator buffer, read-only view or lazily decoded image
+            std::vector<std::uint8_t> image;
+            PixelBuffer buffer;
+            std::shared_ptr<const std::uint8_t> imageView;
+            std::size_t viewSize{0};
+            std::unique_ptr<LazyPixels> lazy;
             std::uint8_t bpp{0};
             TGAHeader header;
+            // Decoding failure of the lazy image a copy was made from
+            std::optional<ErrorCodes> error;
+
+            // Pixels of a failed or mismatching decode are replaced by zeros, so accessors never see a wrong size
+            TGAImage& decoded() const
+            {
+                std::call_once(lazy->decoded, [this]()
+                {
+                    const std::size_t imageSize = static_cast<std::size_t>(width)*height*bpp;
+                    auto result = lazy->decoder();
+                    lazy->decoder = nullptr;
+
+                    if(std::holds_alternative<TGAImage*>(result))
+                    {
+                        lazy->image.reset(std::get<TGAImage*>(result));
+                        if(lazy->image->width() != width || lazy->image->height() != height ||
+                           lazy->image->bitsPerPixel() != bpp || lazy->image->isReadOnly())
+                        {
+                            lazy->image.reset();
+                            lazy->error = ErrorCodes::UnsupportedFormat;
+                        }
+                    }
+                    else
+                    {
+                        lazy->error = std::get<ErrorCodes>(result);
+                    }
+
+                    if(!lazy->image)
+                    {
+                        lazy->image = std::make_unique<TGAImage>(width, height, bpp, header, std::vector<std::uint8_t>(imageSize, 0));
+                    }
+                });
+
+                return *lazy->image;
+            }
+
+            std::optional<ErrorCodes> decodeError() const
+            {
+                if(lazy)
+                {
+                    decoded();
+                    return lazy->error;
+                }
+
+                return error;
+            }
+
+            const std::uint8_t* pixels() const
+            {
+                if(imageView)
+                {
+                    return imageView.get();
+                }
+
+                if(lazy)
+                {
+                    return decoded().constData();
+                }
+
+                return buffer ? buffer.data() : image.data();
+            }
+
+            std::uint8_t* mutablePixels()
+            {
+                if(lazy)
+                {
+                    return decoded().data();
+                }
+
+                return buffer ? buffer.data() : image.data();
+            }
+
+            std::size_t size() const
+            {
+                if(imageView)
+                {
+                    return viewSize;
+                }
+
+                if(lazy)
+                {
+                    return static_cast<std::size_t>(width)*height*bpp;
+                }
+
+                return buffer ? buffer.size() : image.size();
+            }
 
             std::variant<TGAColor, ErrorCodes> color(const int& x, const int& y) const
             {
-                return TGAColor(image.data()+(x+y*width)*bpp, bpp);
+                const auto colorPixels = pixels();
+                if(lazy && lazy->error.has_value())
+                {
+                    return lazy->error.value();
+                }
+
+                return withPixelSize(bpp, [&](auto size) -> std::variant<TGAColor, ErrorCodes>
+                {
+                    constexpr int PixelSize = decltype(size)::value;
+                    if constexpr(PixelSize == 0)
+                    {
+                        return TGAColor(colorPixels+(x+y*width)*bpp, bpp);
+                    }
+                    else
+                    {
+                        // Channels are gathered in a register, narrow stores into the color would stall the wide loads
+                        // returning it
+                        std::uint32_t channels = 0;
+                        copyPixel<PixelSize>(reinterpret_cast<std::uint8_t*>(&channels),
+                                             colorPixels + (static_cast<std::size_t>(y)*width + x)*PixelSize, PixelSize);
+
+                        TGAColor colorValue;
+                        std::memcpy(colorValue.bgra.data(), &channels, sizeof(channels));
+                        colorValue.bpp = bpp;
+                        return colorValue;
+                    }
+                });
             }
 
             void setColor(const int& x, const int& y, const TGAColor& colorValue)
             {
-                std::memcpy(image.data()+(x+y*width)*bpp, colorValue.bgra.data(), bpp);
+                const auto colorPixels = mutablePixels();
+                withPixelSize(bpp, [&](auto size)
+                {
+                    constexpr int PixelSize = decltype(size)::value;
+                    copyPixel<PixelSize>(colorPixels + (static_cast<std::size_t>(y)*width + x)*pixelSize<PixelSize>(bpp),
+                                         colorValue.bgra.data(), bpp);
+                });
             }
     };
 
@@ -69,14 +232,54 @@ std::uint8_t& TGAColor::operator[](const int& index)
         d_ptr->header = header;
     }
 
-    TGAImage::TGAImage(const TGAImage& rhs)
+    TGAImage::TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header,
+                       std::shared_ptr<const std::uint8_t> imageView, const std::size_t& viewSize) : d_ptr{new TGAImageImpl}
+    {
+        d_ptr->width = width;
+        d_ptr->height = height;
+        d_ptr->bpp = bpp;
+        d_ptr->image.clear();
+        d_ptr->imageView = std::move(imageView);
+        d_ptr->viewSize = viewSize;
+        d_ptr->header = header;
+    }
+
+    TGAImage::TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header, std::vector<std::uint8_t>&& imageData) : d_ptr{new TGAImageImpl}
+    {
+        d_ptr->width = width;
+        d_ptr->height = height;
+        d_ptr->bpp = bpp;
+        d_ptr->image = std::move(imageData);
+        d_ptr->header = header;
+    }
+
+    TGAImage::TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header, PixelBuffer&& imageData) : d_ptr{new TGAImageImpl}
+    {
+        d_ptr->width = width;
+        d_ptr->height = height;
+        d_ptr->bpp = bpp;
+        d_ptr->buffer = std::move(imageData);
+        d_ptr->header = header;
+    }
+
+    TGAImage::TGAImage(const int& width, const int& height, const int& bpp, const TGAHeader& header, PixelDecoder decoder) : d_ptr{new TGAImageImpl}
+    {
+        d_ptr->width = width;
+        d_ptr->height = height;
+        d_ptr->bpp = bpp;
+        d_ptr->lazy = std::make_unique<LazyPixels>();
+        d_ptr->lazy->decoder = std::move(decoder);
+        d_ptr->header = header;
+    }
+
+    TGAImage::TGAImage(const TGAImage& rhs) : d_ptr{new TGAImageImpl{*rhs.d_ptr}}
     {
-        d_ptr.reset(rhs.d_ptr.get());
+
     }
 
-    TGAImage::TGAImage(TGAImage&& rhs)
+    TGAImage::TGAImage(TGAImage&& rhs) noexcept : d_ptr{std::move(rhs.d_ptr)}
     {
-        d_ptr.reset(rhs.d_ptr.get());
+
     }
 
     int TGAImage::width() const
@@ -94,8 +297,13 @@ std::uint8_t& TGAColor::operator[](const int& index)
         if(&image == this)
             return *this;
 
-        this->d_ptr.reset(image.d_ptr.get());
+        d_ptr.reset(new TGAImageImpl{*image.d_ptr});
+        return *this;
+    }
 
+    TGAImage& TGAImage::operator=(TGAImage&& image) noexcept
+    {
+        d_ptr = std::move(image.d_ptr);
         return *this;
     }
 
@@ -106,12 +314,42 @@ std::uint8_t& TGAColor::operator[](const int& index)
 
     std::uint8_t* TGAImage::data() const
     {
-        return d_ptr->image.data();
+        if(d_ptr->imageView)
+        {
+            return nullptr;
+        }
+
+        return d_ptr->mutablePixels();
+    }
+
+    const std::uint8_t* TGAImage::constData() const
+    {
+        return d_ptr->pixels();
+    }
+
+    bool TGAImage::isReadOnly() const
+    {
+        return static_cast<bool>(d_ptr->imageView);
+    }
+
+    std::optional<ErrorCodes> TGAImage::decodeError() const
+    {
+        return d_ptr->decodeError();
+    }
+
+    ImageView TGAImage::view()
+    {
+        return ImageView{data(), d_ptr->width, d_ptr->height, d_ptr->bpp};
+    }
+
+    ConstImageView TGAImage::constView() const
+    {
+        return ConstImageView{constData(), d_ptr->width, d_ptr->height, d_ptr->bpp};
     }
 
     int TGAImage::dataSize() const
     {
-        return d_ptr->image.size();
+        return d_ptr->size();
     }
 
     std::variant<TGAColor, ErrorCodes> TGAImage::color(const int& x, const int& y) const
@@ -133,6 +371,11 @@ std::uint8_t& TGAColor::operator[](const int& index)
             return ErrorCodes::IndexOutOfRange;
         }
 
+        if(isReadOnly())
+        {
+            return ErrorCodes::ReadOnlyImage;
+        }
+
         d_ptr->setColor(x, y, colorValue);
 
         return std::nullopt;
@@ -152,4 +395,215 @@ std::uint8_t& TGAColor::operator[](const int& index)
     {
         return d_ptr->header;
     }
+
+    bool TGAImage::containsRect(const int& x, const int& y, const int& width, const int& height) const
+    {
+        return x >= 0 && y >= 0 && width >= 0 && height >= 0 &&
+               x <= d_ptr->width - width && y <= d_ptr->height - height;
+    }
+
+    std::optional<ErrorCodes> TGAImage::fillRect(const int& x, const int& y, const int& width, const int& height, const TGAColor& colorValue)
+    {
+        if(!containsRect(x, y, width, height))
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        if(isReadOnly())
+        {
+            return ErrorCodes::ReadOnlyImage;
+        }
+
+        const auto region = view().crop(x, y, width, height);
+        if(region.empty())
+        {
+            return std::nullopt;
+        }
+
+        // First row is filled pixel by pixel, all other rows are copies of it
+        auto rows = region.begin();
+        const auto firstRow = *rows;
+        for(auto column = 0; column < region.width(); ++column)
+        {
+            std::memcpy(firstRow + column*d_ptr->bpp, colorValue.bgra.data(), d_ptr->bpp);
+        }
+
+        for(++rows; rows != region.end(); ++rows)
+        {
+            std::memcpy(*rows, firstRow, region.rowSize());
+        }
+
+        return std::nullopt;
+    }
+
+    std::variant<TGAImage, ErrorCodes> TGAImage::copyRect(const int& x, const int& y, const int& width, const int& height) const
+    {
+        if(!containsRect(x, y, width, height))
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        const auto region = constView().crop(x, y, width, height);
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width)*height*d_ptr->bpp);
+        auto output = pixels.data();
+        for(auto row : region)
+        {
+            std::memcpy(output, row, region.rowSize());
+            output += region.rowSize();
+        }
+
+        auto header = d_ptr->header;
+        header.width = static_cast<std::uint16_t>(width);
+        header.height = static_cast<std::uint16_t>(height);
+
+        return TGAImage{width, height, d_ptr->bpp, header, std::move(pixels)};
+    }
+
+    std::optional<ErrorCodes> TGAImage::blit(const TGAImage& source, const int& srcX, const int& srcY, const int& width, const int& height,
+                                             const int& dstX, const int& dstY)
+    {
+        if(!source.containsRect(srcX, srcY, width, height) || !containsRect(dstX, dstY, width, height))
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        if(isReadOnly())
+        {
+            return ErrorCodes::ReadOnlyImage;
+        }
+
+        if(source.d_ptr->bpp != d_ptr->bpp)
+        {
+            return ErrorCodes::UnsupportedFormat;
+        }
+
+        const auto from = source.constView().crop(srcX, srcY, width, height);
+        const auto to = view().crop(dstX, dstY, width, height);
+        if(to.empty())
+        {
+            return std::nullopt;
+        }
+
+        // Moving a region of the same image downwards has to start with the bottom row
+        if(&source == this && dstY > srcY)
+        {
+            for(auto row = height - 1; row >= 0; --row)
+            {
+                std::memmove(to.row(row), from.row(row), to.rowSize());
+            }
+        }
+        else
+        {
+            for(auto row = 0; row < height; ++row)
+            {
+                std::memmove(to.row(row), from.row(row), to.rowSize());
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> TGAImage::readRow(const int& y, std::uint8_t* output) const
+    {
+        if(y < 0 || y >= d_ptr->height || output == nullptr)
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        const auto image = constView();
+        std::memcpy(output, image.row(y), image.rowSize());
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> TGAImage::writeRow(const int& y, const std::uint8_t* input)
+    {
+        if(y < 0 || y >= d_ptr->height || input == nullptr)
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        if(isReadOnly())
+        {
+            return ErrorCodes::ReadOnlyImage;
+        }
+
+        const auto image = view();
+        std::memcpy(image.row(y), input, image.rowSize());
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> TGAImage::flipHorizontally()
+    {
+        if(isReadOnly())
+        {
+            return ErrorCodes::ReadOnlyImage;
+        }
+
+        if(d_ptr->bpp < 1 || d_ptr->bpp > maxBytesPerPixel)
+        {
+            return ErrorCodes::UnsupportedFormat;
+        }
+
+        const auto image = view();
+        for(auto row : image)
+        {
+            reversePixels(row, image.width(), image.bytesPerPixel());
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> TGAImage::flipVertically()
+    {
+        if(isReadOnly())
+        {
+            return ErrorCodes::ReadOnlyImage;
+        }
+
+        reverseRows(view());
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> TGAImage::rotate180()
+    {
+        if(isReadOnly())
+        {
+            return ErrorCodes::ReadOnlyImage;
+        }
+
+        const auto image = view();
+        return rotate(image, image, rotationAngle::DEGREES_180);
+    }
+
+    std::optional<ErrorCodes> TGAImage::normalizeOrigin()
+    {
+        if(isReadOnly())
+        {
+            return ErrorCodes::ReadOnlyImage;
+        }
+
+        auto& header = d_ptr->header;
+        const auto reversePixelOrder = (header.imagedescriptor & rightOriginMask) != 0;
+        if(reversePixelOrder && (d_ptr->bpp < 1 || d_ptr->bpp > maxBytesPerPixel))
+        {
+            return ErrorCodes::UnsupportedFormat;
+        }
+
+        if((header.imagedescriptor & topOriginMask) == 0)
+        {
+            flipVertically();
+        }
+
+        if(reversePixelOrder)
+        {
+            flipHorizontally();
+        }
+
+        header.imagedescriptor = static_cast<std::uint8_t>((header.imagedescriptor & ~rightOriginMask) | topOriginMask);
+
+        return std::nullopt;
+    }
 } // namespace imageloader
@@ -1,218 +1,1044 @@
 #include "tgaImage/TGAImageLoad.hpp"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#include <mutex>
 #include <optional>
 
+#include "AsyncFileIO.hpp"
+#include "MappedFile.hpp"
+#include "MetricsRecorder.hpp"
+#include "Orientation.hpp"
+#include "RunLength.hpp"
+#include "TGAFormat.hpp"
+#include "ThreadPool.hpp"
+
 namespace imageloader
 {
 
-    enum TYPE_FORMAT : std::uint8_t
-    {
-        UNCOMPRESSED_RGB = 2,
-        UNCOMPRESSED_BW = 3,
-        COMPRESSED_RGB = 10,
-        COMPRESSED_BW = 11
-    };
-
-    constexpr auto maxChunkLength = 128;
-    constexpr auto maxDataLenghtRLE = 127;
-    constexpr auto runLengthMask = 0x80;
+    // Compressed data is read from and written to the file in blocks of this size
+    constexpr auto readBlockSize = 256*1024;
+    constexpr auto writeBlockSize = 1024*1024;
+    // Smallest band of rows encoded by a single task in parallel compression
+    constexpr std::size_t minBandPixels = 64*1024;
+    // Stored pixels decoded before they are converted to the requested format
+    constexpr std::size_t convertBlockPixels = 16*1024;
 
     class TGAImageLoaderImpl
     {
         public:
 
-        std::variant<TGAImage*, ErrorCodes> loadImage(const std::string_view& imagePath)
+        explicit TGAImageLoaderImpl(const unsigned int& workerCount) : workerCount{workerCount}
         {
-            std::ifstream inputFile(imagePath.data(), std::ios::binary);
 
-            if(!inputFile.is_open())
+        }
+
+        // Worker threads are only started once a batch operation is requested
+        utils::threading::ThreadPool& workerPool()
+        {
+            std::call_once(poolInitialized, [this](){ pool = std::make_unique<utils::threading::ThreadPool>(workerCount); });
+            return *pool;
+        }
+
+        std::variant<TGAImage*, ErrorCodes> loadImage(const std::string_view& imagePath, const StatisticsSink& statisticsSink)
+        {
+            std::ifstream inputFile;
+            if(!openFile(inputFile, imagePath))
             {
                 return ErrorCodes::UnableToOpenImage;
             }
 
             TGAHeader header{};
-            inputFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if(!readHeader(inputFile, header))
+            {
+                inputFile.close();
+                return ErrorCodes::InvalidReadOperation;
+            }
 
-            if(!inputFile.good())
+            if(!isSupportedPixelSize(header))
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
+            inputFile.seekg(pixelDataOffset(header));
+
+            const auto width = header.width;
+            const auto height = header.height;
+            const auto bpp = (header.bitsperpixel)>>3;
+
+            const std::size_t imageBufferSize = static_cast<std::size_t>(width)*height*bpp;
+
+            // The pixel buffer is allocated once, every byte of it is overwritten below
+            auto image = allocatePixels(imageBufferSize);
+            auto statistics = statisticsAccumulator(header, statisticsSink);
+
+            if(isUncompressedFormat(header))
+            {
+                auto result = readPixels(inputFile, image.data(), imageBufferSize, statistics);
+                if(result.has_value())
+                {
+                    inputFile.close();
+                    return result.value();
+                }
+            }
+            else if(isCompressedFormat(header))
+            {
+                auto result = decompressRunLength(inputFile, header, image.data(), statistics);
+                if(result.has_value())
+                {
+                    return result.value();
+                }
+            }
+            else
+            {
+                std::memset(image.data(), 0, imageBufferSize);
+                addPixels(statistics, image.data(), image.data() + imageBufferSize);
+            }
+
+            if(statistics.has_value())
+            {
+                statisticsSink(imagePath, statistics->statistics());
+            }
+
+            metrics->count(metricCounter::IMAGES_LOADED, 1);
+            return new TGAImage{width, height, bpp, header, std::move(image)};
+        }
+
+        std::variant<TGAImage*, ErrorCodes> loadImage(const std::string_view& imagePath, const LoadOptions& options)
+        {
+            if(loadMode::LAZY == options.mode)
+            {
+                return loadLazyImage(imagePath, options);
+            }
+
+            if(!options.format.has_value() && !options.normalizeOrigin)
+            {
+                return loadMode::MEMORY_MAPPED == options.mode ? loadMappedImage(imagePath, options.statistics)
+                                                               : loadImage(imagePath, options.statistics);
+            }
+
+            std::ifstream inputFile;
+            if(!openFile(inputFile, imagePath))
+            {
+                return ErrorCodes::UnableToOpenImage;
+            }
+
+            TGAHeader header{};
+            if(!readHeader(inputFile, header))
+            {
+                return ErrorCodes::InvalidReadOperation;
+            }
+
+            const auto storedFormat = nativePixelFormat(header);
+            if(std::holds_alternative<ErrorCodes>(storedFormat) || (!isUncompressedFormat(header) && !isCompressedFormat(header)))
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
+            const auto format = options.format.value_or(std::get<pixelFormat>(storedFormat));
+            const auto isTopLeft = (header.imagedescriptor & (topOriginMask | rightOriginMask)) == topOriginMask;
+            if(format == std::get<pixelFormat>(storedFormat) && (!options.normalizeOrigin || isTopLeft))
             {
                 inputFile.close();
+                return loadImage(imagePath, LoadOptions{options.mode, std::nullopt, false, options.statistics});
+            }
+
+            inputFile.seekg(pixelDataOffset(header));
+
+            const auto width = header.width;
+            const auto height = header.height;
+            const auto bpp = bytesPerPixel(format);
+
+            auto image = allocatePixels(static_cast<std::size_t>(width)*height*bpp);
+            std::optional<StatisticsAccumulator> statistics;
+            if(options.statistics)
+            {
+                statistics.emplace(format);
+            }
+
+            auto result = transformStoredPixels(inputFile, header, std::get<pixelFormat>(storedFormat), image.data(), format,
+                                                options.normalizeOrigin, statistics);
+            if(result.has_value())
+            {
+                return result.value();
+            }
+
+            if(statistics.has_value())
+            {
+                options.statistics(imagePath, statistics->statistics());
+            }
+
+            metrics->count(metricCounter::IMAGES_LOADED, 1);
+            return new TGAImage{width, height, bpp, convertedHeader(header, options.format, options.normalizeOrigin), std::move(image)};
+        }
+
+        // Header and size of the image are those loadImage(imagePath, options) is going to return
+        std::variant<TGAImage*, ErrorCodes> loadLazyImage(const std::string_view& imagePath, const LoadOptions& options)
+        {
+            auto probeResult = probeImage(imagePath);
+            if(std::holds_alternative<ErrorCodes>(probeResult))
+            {
+                return std::get<ErrorCodes>(probeResult);
+            }
+
+            auto header = std::get<ImageInfo>(probeResult).header;
+            if(!isSupportedPixelSize(header))
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
+            if(options.format.has_value() || options.normalizeOrigin)
+            {
+                const auto storedFormat = nativePixelFormat(header);
+                if(std::holds_alternative<ErrorCodes>(storedFormat) || (!isUncompressedFormat(header) && !isCompressedFormat(header)))
+                {
+                    return ErrorCodes::UnsupportedFormat;
+                }
+
+                const auto format = options.format.value_or(std::get<pixelFormat>(storedFormat));
+                const auto isTopLeft = (header.imagedescriptor & (topOriginMask | rightOriginMask)) == topOriginMask;
+                if(format != std::get<pixelFormat>(storedFormat) || (options.normalizeOrigin && !isTopLeft))
+                {
+                    header = convertedHeader(header, options.format, options.normalizeOrigin);
+                }
+            }
+
+            auto decodeOptions = options;
+            decodeOptions.mode = loadMode::COPY;
+            PixelDecoder decoder = [imagePath = std::string{imagePath}, decodeOptions, pixelAllocator = allocator, loaderMetrics = metrics]()
+            {
+                // The loader may be gone by the time the pixels are needed, so the image decodes on its own
+                TGAImageLoaderImpl loader{1};
+                loader.allocator = pixelAllocator;
+                loader.metrics = loaderMetrics;
+                return loader.loadImage(imagePath, decodeOptions);
+            };
+
+            return new TGAImage{header.width, header.height, header.bitsperpixel>>3, header, std::move(decoder)};
+        }
+
+        std::variant<ImageInfo, ErrorCodes> probeImage(const std::string_view& imagePath)
+        {
+            // Unbuffered, so nothing but the requested bytes is read from the file
+            std::ifstream inputFile;
+            inputFile.rdbuf()->pubsetbuf(nullptr, 0);
+            if(!openFile(inputFile, imagePath))
+            {
+                return ErrorCodes::UnableToOpenImage;
+            }
+
+            StageTimer timer{*metrics, loadStage::HEADER};
+            ImageInfo info;
+            inputFile.read(reinterpret_cast<char*>(&info.header), sizeof(info.header));
+            info.id.resize(info.header.idlenght);
+            inputFile.read(info.id.data(), info.id.size());
+
+            if(!inputFile.good())
+            {
+                return ErrorCodes::InvalidReadOperation;
+            }
+
+            inputFile.seekg(0, std::ios::end);
+            info.fileSize = static_cast<std::uintmax_t>(inputFile.tellg());
+
+            if(info.fileSize >= sizeof(TGAHeader) + footerSize)
+            {
+                std::uint8_t footer[footerSize];
+                inputFile.seekg(-static_cast<std::streamoff>(footerSize), std::ios::end);
+                inputFile.read(reinterpret_cast<char*>(footer), footerSize);
+
+                if(!inputFile.good())
+                {
+                    return ErrorCodes::InvalidReadOperation;
+                }
+
+                info.hasFooter = parseFooter(footer, info.extensionOffset, info.developerOffset);
+                metrics->count(metricCounter::BYTES_READ, footerSize);
+            }
+
+            metrics->count(metricCounter::BYTES_READ, sizeof(TGAHeader) + info.id.size());
+            return info;
+        }
+
+        std::variant<TGAImage*, ErrorCodes> loadMappedImage(const std::string_view& imagePath, const StatisticsSink& statisticsSink)
+        {
+            auto mapResult = [&]()
+            {
+                StageTimer timer{*metrics, loadStage::OPEN};
+                return MappedFile::open(imagePath);
+            }();
+            if(std::holds_alternative<ErrorCodes>(mapResult))
+            {
+                return std::get<ErrorCodes>(mapResult);
+            }
+
+            auto mappedFile = std::get<std::shared_ptr<MappedFile>>(mapResult);
+            auto headerResult = parseHeader(mappedFile->data(), mappedFile->size());
+            if(std::holds_alternative<ErrorCodes>(headerResult))
+            {
+                return std::get<ErrorCodes>(headerResult);
+            }
+
+            const auto header = std::get<TGAHeader>(headerResult);
+            if(!isSupportedPixelSize(header))
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
+            if(!isUncompressedFormat(header))
+            {
+                // RLE data is decoded straight from the mapping into an owned buffer
+                auto statistics = statisticsAccumulator(header, statisticsSink);
+                auto result = decodeImage(mappedFile->data(), mappedFile->size(), statistics, true);
+                if(statistics.has_value() && std::holds_alternative<TGAImage*>(result))
+                {
+                    statisticsSink(imagePath, statistics->statistics());
+                }
+
+                return result;
+            }
+
+            const auto width = header.width;
+            const auto height = header.height;
+            const auto bpp = (header.bitsperpixel)>>3;
+
+            const std::size_t imageBufferSize = static_cast<std::size_t>(width)*height*bpp;
+            const auto offset = pixelDataOffset(header);
+            if(offset + imageBufferSize > mappedFile->size())
+            {
                 return ErrorCodes::InvalidReadOperation;
             }
 
+            //Aliasing constructor, the view keeps the whole mapping alive
+            std::shared_ptr<const std::uint8_t> imageView{mappedFile, mappedFile->data() + offset};
+            metrics->count(metricCounter::IMAGES_LOADED, 1);
+            auto image = new TGAImage{width, height, bpp, header, std::move(imageView), imageBufferSize};
+
+            // Nothing is decoded, counting is the first pass over the mapped pixels
+            if(statisticsSink)
+            {
+                auto statistics = computeStatistics(*image);
+                if(std::holds_alternative<ImageStatistics>(statistics))
+                {
+                    statisticsSink(imagePath, std::get<ImageStatistics>(statistics));
+                }
+            }
+
+            return image;
+        }
+
+        // countCopiedBytes is false for files read by the I/O backend, whose bytes were counted when they arrived
+        std::variant<TGAImage*, ErrorCodes> decodeImage(const std::uint8_t* data, const std::size_t& size,
+                                                        std::optional<StatisticsAccumulator>& statistics,
+                                                        const bool& countCopiedBytes)
+        {
+            auto headerResult = parseHeader(data, size);
+            if(std::holds_alternative<ErrorCodes>(headerResult))
+            {
+                return std::get<ErrorCodes>(headerResult);
+            }
+
+            const auto header = std::get<TGAHeader>(headerResult);
+            if(!isSupportedPixelSize(header))
+            {
+                return ErrorCodes::UnsupportedFormat;
+            }
+
             const auto width = header.width;
             const auto height = header.height;
             const auto bpp = (header.bitsperpixel)>>3;
 
-            const auto imageBufferSize = width*height*bpp;
+            const std::size_t imageBufferSize = static_cast<std::size_t>(width)*height*bpp;
+            const auto offset = pixelDataOffset(header);
+
+            if(isUncompressedFormat(header) && offset + imageBufferSize > size)
+            {
+                return ErrorCodes::InvalidReadOperation;
+            }
+
+            auto image = allocatePixels(imageBufferSize);
+
+            if(isUncompressedFormat(header))
+            {
+                {
+                    StageTimer timer{*metrics, loadStage::READ};
+                    std::memcpy(image.data(), data + offset, imageBufferSize);
+                }
+                if(countCopiedBytes)
+                {
+                    metrics->count(metricCounter::BYTES_READ, imageBufferSize);
+                }
+                addPixels(statistics, image.data(), image.data() + imageBufferSize);
+            }
+            else if(isCompressedFormat(header))
+            {
+                auto result = decompressRunLength(data + offset, size - offset, header, image.data(), statistics);
+                if(result.has_value())
+                {
+                    return result.value();
+                }
+            }
+            else
+            {
+                std::memset(image.data(), 0, imageBufferSize);
+                addPixels(statistics, image.data(), image.data() + imageBufferSize);
+            }
+
+            metrics->count(metricCounter::IMAGES_LOADED, 1);
+            return new TGAImage{width, height, bpp, header, std::move(image)};
+        }
+
+        std::variant<std::string, ErrorCodes> storeImage(const std::string_view& imagePath, const TGAImage& image,
+                                                         const compressionStatus& status)
+        {
+            std::ofstream outputFile;
+            {
+                StageTimer timer{*metrics, loadStage::OPEN};
+                outputFile.open(imagePath.data(), std::ios::binary | std::ios::out);
+            }
+            if(!outputFile.is_open())
+            {
+                return ErrorCodes::UnableToOpenImage;
+            }
+
+            const ByteSink fileSink = [this, &outputFile](const std::uint8_t* data, const std::size_t& size)
+            {
+                StageTimer timer{*metrics, loadStage::WRITE};
+                outputFile.write(reinterpret_cast<const char*>(data), size);
+                metrics->count(metricCounter::BYTES_WRITTEN, size);
+                return outputFile.good();
+            };
+
+            auto result = encodeImage(image, fileSink, status);
+            if(result.has_value())
+            {
+                outputFile.close();
+                if(std::filesystem::exists(imagePath.data()))
+                {
+                    std::filesystem::remove(imagePath.data());
+                }
+
+                return result.value();
+            }
+
+            {
+                // Buffered bytes reach the file here
+                StageTimer timer{*metrics, loadStage::WRITE};
+                outputFile.close();
+            }
+
+            metrics->count(metricCounter::IMAGES_STORED, 1);
+            return std::string{imagePath};
+        }
+
+        std::optional<ErrorCodes> encodeImage(const TGAImage& image, const ByteSink& sink, const compressionStatus& status)
+        {
+            auto header = storedHeader(image.getHeader(), compressionStatus::NO != status);
+            if(!sink(reinterpret_cast<const std::uint8_t*>(&header), sizeof(header)))
+            {
+                return ErrorCodes::InvalidWriteOperation;
+            }
+
+            if(compressionStatus::NO == status)
+            {
+                if(!sink(image.constData(), image.dataSize()))
+                {
+                    return ErrorCodes::InvalidWriteOperation;
+                }
+
+                return std::nullopt;
+            }
+
+            StageTimer timer{*metrics, loadStage::ENCODE};
+            return compressionStatus::PARALLEL == status ? compressRunLengthParallel(sink, image.constData(), header)
+                                                         : compressRunLength(sink, image.constData(), header);
+        }
+
+        // The calling thread and the workers submit whole-file reads to the I/O backend and decode the files whose reads
+        // completed, so decoding overlaps with the reads still in flight. Files waiting to be decoded count as in flight
+        // too, which keeps at most queueDepth file buffers alive. An exception ends its file only, every participant keeps
+        // going until all reads completed and the first exception is rethrown afterwards.
+        std::vector<std::variant<TGAImage*, ErrorCodes>> loadImagesAsync(const std::vector<std::string>& imagePaths,
+                                                                         const StatisticsSink& statisticsSink)
+        {
+            const auto count = imagePaths.size();
+            std::vector<std::variant<TGAImage*, ErrorCodes>> results(count, ErrorCodes::InvalidReadOperation);
+            std::vector<std::variant<FileContents, ErrorCodes>> files(count);
+
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::size_t nextFile = 0;
+            std::size_t inFlight = 0;
+            std::size_t finished = 0;
+            std::deque<std::size_t> readFiles;
+            std::exception_ptr failure;
+
+            workerPool().parallelFor(workerPool().workerCount(), [&](const std::size_t&)
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                while(finished < count)
+                {
+                    if(!readFiles.empty())
+                    {
+                        const auto index = readFiles.front();
+                        readFiles.pop_front();
+                        lock.unlock();
+
+                        std::exception_ptr error;
+                        try
+                        {
+                            results[index] = decodeFile(imagePaths[index], files[index], statisticsSink);
+                        }
+                        catch(...)
+                        {
+                            error = std::current_exception();
+                        }
+                        files[index] = FileContents{};
+
+                        lock.lock();
+                        if(error && !failure)
+                        {
+                            failure = error;
+                        }
+                        --inFlight;
+                        ++finished;
+                    }
+                    else if(nextFile < count && inFlight < io->queueDepth())
+                    {
+                        const auto index = nextFile++;
+                        ++inFlight;
+                        lock.unlock();
+
+                        std::optional<ErrorCodes> result;
+                        std::exception_ptr error;
+                        try
+                        {
+                            result = submitRead(imagePaths[index], [&, index](std::variant<FileContents, ErrorCodes> contents)
+                            {
+                                files[index] = std::move(contents);
+                                std::lock_guard<std::mutex> guard{mutex};
+                                readFiles.push_back(index);
+                                changed.notify_all();
+                            });
+                        }
+                        catch(...)
+                        {
+                            // Nothing was submitted, so no completion is going to count the file
+                            error = std::current_exception();
+                            result = ErrorCodes::InvalidReadOperation;
+                        }
+
+                        lock.lock();
+                        if(error && !failure)
+                        {
+                            failure = error;
+                        }
+                        if(result.has_value())
+                        {
+                            results[index] = result.value();
+                            --inFlight;
+                            ++finished;
+                        }
+                    }
+                    else
+                    {
+                        changed.wait(lock);
+                    }
+                }
+
+                changed.notify_all();
+            });
+
+            if(failure)
+            {
+                for(auto& result : results)
+                {
+                    if(std::holds_alternative<TGAImage*>(result))
+                    {
+                        delete std::get<TGAImage*>(result);
+                    }
+                }
+
+                std::rethrow_exception(failure);
+            }
+
+            return results;
+        }
+
+        // Images are encoded into memory by the calling thread and the workers, their writes run on the I/O backend
+        // while the next images are encoded. Encoded buffers live until their write completed, at most queueDepth of them.
+        // As with loads, an exception is rethrown once all writes completed.
+        std::vector<std::variant<std::string, ErrorCodes>> storeImagesAsync(const std::vector<std::string>& imagePaths,
+                                                                            const std::vector<const TGAImage*>& images,
+                                                                            const compressionStatus& status,
+                                                                            const std::function<bool(const std::string_view&)>& prepareDirectory)
+        {
+            const auto count = std::min(imagePaths.size(), images.size());
+            std::vector<std::variant<std::string, ErrorCodes>> results(imagePaths.size(), ErrorCodes::InvalidWriteOperation);
+            std::vector<std::vector<std::uint8_t>> buffers(count);
+
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::size_t nextImage = 0;
+            std::size_t inFlight = 0;
+            std::size_t finished = 0;
+            std::exception_ptr failure;
+
+            workerPool().parallelFor(workerPool().workerCount(), [&](const std::size_t&)
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                while(finished < count)
+                {
+                    if(nextImage < count && inFlight < io->queueDepth())
+                    {
+                        const auto index = nextImage++;
+                        ++inFlight;
+                        lock.unlock();
+
+                        std::optional<ErrorCodes> result;
+                        std::exception_ptr error;
+                        try
+                        {
+                            result = submitWrite(imagePaths[index], images[index], buffers[index], status, prepareDirectory,
+                                                 [&, index](std::variant<std::string, ErrorCodes> stored)
+                            {
+                                results[index] = std::move(stored);
+                                buffers[index] = std::vector<std::uint8_t>{};
+                                std::lock_guard<std::mutex> guard{mutex};
+                                --inFlight;
+                                ++finished;
+                                changed.notify_all();
+                            });
+                        }
+                        catch(...)
+                        {
+                            // Nothing was submitted, so no completion is going to count the image
+                            error = std::current_exception();
+                            result = ErrorCodes::InvalidWriteOperation;
+                        }
+
+                        lock.lock();
+                        if(error && !failure)
+                        {
+                            failure = error;
+                        }
+                        if(result.has_value())
+                        {
+                            results[index] = result.value();
+                            buffers[index] = std::vector<std::uint8_t>{};
+                            --inFlight;
+                            ++finished;
+                        }
+                    }
+                    else
+                    {
+                        changed.wait(lock);
+                    }
+                }
+
+                changed.notify_all();
+            });
+
+            if(failure)
+            {
+                std::rethrow_exception(failure);
+            }
+
+            return results;
+        }
+
+        bool pathExists(const std::string_view& path)
+        {
+            StageTimer timer{*metrics, loadStage::PATH_CHECK};
+            // Paths the filesystem refuses to look at, e.g. with an overlong name, do not exist
+            std::error_code error;
+            return std::filesystem::exists(path, error);
+        }
+
+            std::shared_ptr<PixelAllocator> allocator{defaultPixelAllocator()};
+            // Shared with lazy images, which record their decode after the loader is gone
+            std::shared_ptr<MetricsRecorder> metrics{std::make_shared<MetricsRecorder>()};
+            // Backend of batch loads and stores, nullptr while they block
+            std::unique_ptr<AsyncFileIO> io;
+
+        private:
+            unsigned int workerCount{0};
+            std::once_flag poolInitialized;
+            std::unique_ptr<utils::threading::ThreadPool> pool;
+
+            bool openFile(std::ifstream& inputFile, const std::string_view& imagePath)
+            {
+                StageTimer timer{*metrics, loadStage::OPEN};
+                inputFile.open(imagePath.data(), std::ios::binary);
+                return inputFile.is_open();
+            }
+
+            bool readHeader(std::ifstream& inputFile, TGAHeader& header)
+            {
+                StageTimer timer{*metrics, loadStage::HEADER};
+                inputFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+                metrics->count(metricCounter::BYTES_READ, static_cast<std::uint64_t>(inputFile.gcount()));
+                return inputFile.good();
+            }
+
+            PixelBuffer allocatePixels(const std::size_t& size)
+            {
+                StageTimer timer{*metrics, loadStage::ALLOCATE};
+                metrics->count(metricCounter::ALLOCATIONS, 1);
+                metrics->count(metricCounter::ALLOCATED_BYTES, size);
+                return PixelBuffer{allocator, size};
+            }
+
+            // Bytes are counted once the whole file arrived, the transfer itself runs on the backend and is not timed
+            std::optional<ErrorCodes> submitRead(const std::string& imagePath, ReadCompletion completion)
+            {
+                if(!pathExists(imagePath))
+                {
+                    return ErrorCodes::InvalidPath;
+                }
+
+                StageTimer timer{*metrics, loadStage::OPEN};
+                return io->readFile(imagePath, [this, completion = std::move(completion)](std::variant<FileContents, ErrorCodes> contents)
+                {
+                    if(std::holds_alternative<FileContents>(contents))
+                    {
+                        metrics->count(metricCounter::BYTES_READ, std::get<FileContents>(contents).size);
+                    }
+
+                    completion(std::move(contents));
+                });
+            }
+
+            std::variant<TGAImage*, ErrorCodes> decodeFile(const std::string_view& imagePath, const std::variant<FileContents, ErrorCodes>& file,
+                                                           const StatisticsSink& statisticsSink)
+            {
+                if(std::holds_alternative<ErrorCodes>(file))
+                {
+                    return std::get<ErrorCodes>(file);
+                }
+
+                const auto& contents = std::get<FileContents>(file);
+                std::optional<StatisticsAccumulator> statistics;
+                const auto headerResult = parseHeader(contents.data.get(), contents.size);
+                if(std::holds_alternative<TGAHeader>(headerResult))
+                {
+                    statistics = statisticsAccumulator(std::get<TGAHeader>(headerResult), statisticsSink);
+                }
+
+                auto result = decodeImage(contents.data.get(), contents.size, statistics, false);
+                if(statistics.has_value() && std::holds_alternative<TGAImage*>(result))
+                {
+                    statisticsSink(imagePath, statistics->statistics());
+                }
+
+                return result;
+            }
+
+            // The encoded image is kept in buffer until the write completed, a failed write removes the partial file
+            std::optional<ErrorCodes> submitWrite(const std::string& imagePath, const TGAImage* image, std::vector<std::uint8_t>& buffer,
+                                                  const compressionStatus& status,
+                                                  const std::function<bool(const std::string_view&)>& prepareDirectory,
+                                                  std::function<void(std::variant<std::string, ErrorCodes>)> completion)
+            {
+                if(image == nullptr)
+                {
+                    return ErrorCodes::InvalidWriteOperation;
+                }
 
-            auto image = std::vector<std::uint8_t>(imageBufferSize, 0);
-            image.reserve(imageBufferSize);
+                if(!prepareDirectory(imagePath))
+                {
+                    return ErrorCodes::InvalidPath;
+                }
 
-            if(header.imagetypecode == TYPE_FORMAT::UNCOMPRESSED_RGB ||
-               header.imagetypecode == TYPE_FORMAT::UNCOMPRESSED_BW)
-            {
-                inputFile.read(reinterpret_cast<char*>(image.data()), imageBufferSize);
-                if(!inputFile.good())
+                if(compressionStatus::NO == status)
                 {
-                    inputFile.close();
-                    return ErrorCodes::InvalidReadOperation;
+                    buffer.reserve(sizeof(TGAHeader) + image->dataSize());
                 }
-            }
-            else if(header.imagetypecode == TYPE_FORMAT::COMPRESSED_RGB ||
-                    header.imagetypecode == TYPE_FORMAT::COMPRESSED_BW)
-            {
-                auto result = decompressRunLength(inputFile, header);
-                if(std::holds_alternative<ErrorCodes>(result))
+
+                auto result = encodeImage(*image, [&buffer](const std::uint8_t* data, const std::size_t& size)
+                {
+                    buffer.insert(buffer.end(), data, data + size);
+                    return true;
+                }, status);
+                if(result.has_value())
                 {
-                    return std::get<ErrorCodes>(result);
+                    return result;
                 }
 
-                image = std::get<std::vector<std::uint8_t>>(result);
-            }
+                StageTimer timer{*metrics, loadStage::OPEN};
+                return io->writeFile(imagePath, buffer.data(), buffer.size(),
+                                     [this, imagePath, size = buffer.size(), completion = std::move(completion)](std::optional<ErrorCodes> written)
+                {
+                    if(written.has_value())
+                    {
+                        std::error_code error;
+                        std::filesystem::remove(imagePath, error);
+                        completion(written.value());
+                        return;
+                    }
 
-            return new TGAImage{width, height, bpp, header, image};
-        }
+                    metrics->count(metricCounter::BYTES_WRITTEN, size);
+                    metrics->count(metricCounter::IMAGES_STORED, 1);
+                    completion(imagePath);
+                });
+            }
 
-        std::variant<std::string, ErrorCodes> storeImage(const std::string_view& imagePath, const TGAImage& image)
-        {
-            std::ofstream outputFile(imagePath.data(), std::ios::binary | std::ios::out);
-            if(!outputFile.is_open())
+            // Header of an image converted to format while loading, see LoadOptions. Without a format only the origin
+            // changes, so the header matches the one TGAImage::normalizeOrigin leaves behind.
+            static TGAHeader convertedHeader(const TGAHeader& header, const std::optional<pixelFormat>& format, const bool& normalizeOrigin)
             {
-                return ErrorCodes::UnableToOpenImage;
-            }
+                auto imageHeader = format.has_value() ? formatHeader(header, format.value()) : header;
+                if(normalizeOrigin)
+                {
+                    imageHeader.imagedescriptor = static_cast<std::uint8_t>((imageHeader.imagedescriptor & ~rightOriginMask) | topOriginMask);
+                }
 
-            auto header = image.getHeader();
-            outputFile.write(reinterpret_cast<char*>(&header), sizeof(header));
+                return imageHeader;
+            }
 
-            if(!outputFile.good())
+            static std::optional<StatisticsAccumulator> statisticsAccumulator(const TGAHeader& header, const StatisticsSink& statisticsSink)
             {
-                outputFile.close();
-                if(std::filesystem::exists(imagePath.data()))
+                const auto format = nativePixelFormat(header);
+                if(!statisticsSink || std::holds_alternative<ErrorCodes>(format))
                 {
-                    std::filesystem::remove(imagePath.data());
+                    return std::nullopt;
                 }
 
-                return ErrorCodes::InvalidWriteOperation;
+                return StatisticsAccumulator{std::get<pixelFormat>(format)};
             }
 
-            outputFile.write(reinterpret_cast<char*>(image.data()), image.dataSize());
-            if(!outputFile.good())
+            // Counts the whole pixels of [begin, end)
+            static void addPixels(std::optional<StatisticsAccumulator>& statistics, const std::uint8_t* begin, const std::uint8_t* end)
             {
-                outputFile.close();
-                if(std::filesystem::exists(imagePath.data()))
+                if(statistics.has_value())
                 {
-                    std::filesystem::remove(imagePath.data());
+                    statistics->add(begin, static_cast<std::size_t>(end - begin)/bytesPerPixel(statistics->format()));
                 }
-
-                return ErrorCodes::InvalidWriteOperation;
             }
 
-            outputFile.close();
-            return std::string{imagePath};
-        }
+            bool readBlock(std::ifstream& inputFile, std::uint8_t* data, const std::size_t& size)
+            {
+                StageTimer timer{*metrics, loadStage::READ};
+                inputFile.read(reinterpret_cast<char*>(data), size);
+                metrics->count(metricCounter::BYTES_READ, static_cast<std::uint64_t>(inputFile.gcount()));
+                return inputFile.good();
+            }
 
-        std::variant<std::string, ErrorCodes> storeCompressedImage(const std::string_view& imagePath, const TGAImage& image)
-        {
-            std::ofstream outputFile(imagePath.data(), std::ios::binary | std::ios::out);
-            if(!outputFile.is_open())
+            // Reads up to size bytes, a short read at the end of the file is no error
+            std::streamsize readPartialBlock(std::ifstream& inputFile, std::uint8_t* data, const std::size_t& size)
             {
-                return ErrorCodes::UnableToOpenImage;
+                StageTimer timer{*metrics, loadStage::READ};
+                inputFile.read(reinterpret_cast<char*>(data), size);
+                metrics->count(metricCounter::BYTES_READ, static_cast<std::uint64_t>(inputFile.gcount()));
+                return inputFile.gcount();
             }
 
-            auto header = image.getHeader();
-            outputFile.write(reinterpret_cast<char*>(&header), sizeof(header));
-            if(!outputFile.good())
+            std::optional<ErrorCodes> decodeRunLength(RunLengthDecoder& decoder, const std::uint8_t*& input, const std::uint8_t* inputEnd,
+                                                      std::uint8_t*& output, std::uint8_t* outputEnd)
             {
-                return ErrorCodes::InvalidWriteOperation;
+                StageTimer timer{*metrics, loadStage::DECODE};
+                return decoder.decode(input, inputEnd, output, outputEnd);
             }
 
-            auto result = compressRunLength(outputFile, image.data(), header);
-            if(!result.has_value())
+            // Uncompressed pixels are read in one go, or in blocks counted right after they arrived
+            std::optional<ErrorCodes> readPixels(std::ifstream& inputFile, std::uint8_t* data, const std::size_t& size,
+                                                 std::optional<StatisticsAccumulator>& statistics)
             {
-                return std::string{imagePath.data()};
+                const auto pixelSize = statistics.has_value() ? static_cast<std::size_t>(bytesPerPixel(statistics->format())) : 1;
+                const auto blockSize = statistics.has_value() ? readBlockSize/pixelSize*pixelSize : size;
+                for(std::size_t offset = 0; offset < size; offset += blockSize)
+                {
+                    const auto bytes = std::min(blockSize, size - offset);
+                    if(!readBlock(inputFile, data + offset, bytes))
+                    {
+                        return ErrorCodes::InvalidReadOperation;
+                    }
+
+                    addPixels(statistics, data + offset, data + offset + bytes);
+                }
+
+                return std::nullopt;
             }
 
-            return result.value();
-        }
+            std::optional<ErrorCodes> decompressRunLength(std::ifstream& inputFile, const TGAHeader& header, std::uint8_t* data,
+                                                          std::optional<StatisticsAccumulator>& statistics)
+            {
+                const std::size_t pixelCount = static_cast<std::size_t>(header.width)*header.height;
+                const auto bytesPerPixel = header.bitsperpixel>>3;
 
-        private:
+                std::vector<std::uint8_t> block(readBlockSize);
+
+                RunLengthDecoder decoder{bytesPerPixel, pixelCount};
+                auto output = data;
+                const auto outputEnd = data + pixelCount*bytesPerPixel;
+
+                while(!decoder.finished())
+                {
+                    const auto bytesRead = readPartialBlock(inputFile, block.data(), block.size());
+                    if(bytesRead <= 0)
+                    {
+                        return ErrorCodes::InvalidReadOperation;
+                    }
+
+                    const std::uint8_t* input = block.data();
+                    const auto decoded = output;
+                    auto result = decodeRunLength(decoder, input, input + bytesRead, output, outputEnd);
+                    if(result.has_value())
+                    {
+                        return result;
+                    }
+
+                    addPixels(statistics, decoded, output);
+                }
+
+                metrics->count(metricCounter::PACKETS_DECODED, decoder.packetCount());
+                return std::nullopt;
+            }
 
-            std::variant<std::vector<std::uint8_t>, ErrorCodes> decompressRunLength(std::ifstream& inputFile, const TGAHeader& header)
+            std::optional<ErrorCodes> decompressRunLength(const std::uint8_t* input, const std::size_t& inputSize,
+                                                          const TGAHeader& header, std::uint8_t* data,
+                                                          std::optional<StatisticsAccumulator>& statistics)
             {
-                const auto pixelCount = header.width*header.height;
-                auto currentPixel = 0;
-                auto currentByte = 0;
+                const std::size_t pixelCount = static_cast<std::size_t>(header.width)*header.height;
                 const auto bytesPerPixel = header.bitsperpixel>>3;
-                TGAColor color;
+                const auto inputEnd = input + inputSize;
+                const auto outputEnd = data + pixelCount*bytesPerPixel;
 
-                std::vector<std::uint8_t> data(pixelCount*bytesPerPixel, 0);
+                // Without statistics the whole image is decoded at once, otherwise in blocks counted while they are in cache
+                const auto blockSize = statistics.has_value() ? static_cast<std::size_t>(readBlockSize)/bytesPerPixel*bytesPerPixel
+                                                              : pixelCount*bytesPerPixel;
 
-                while(currentPixel < pixelCount)
+                RunLengthDecoder decoder{bytesPerPixel, pixelCount};
+                auto output = data;
+                while(output != outputEnd)
                 {
-                    auto chunkHeader = static_cast<std::uint8_t>(inputFile.get());
+                    const auto decoded = output;
+                    auto result = decodeRunLength(decoder, input, inputEnd, output, std::min(outputEnd, output + blockSize));
+                    if(result.has_value())
+                    {
+                        return result;
+                    }
 
-                    if(!inputFile.good())
+                    addPixels(statistics, decoded, output);
+                    if(output == decoded)
                     {
-                        return ErrorCodes::InvalidReadOperation;
+                        break;
                     }
+                }
+
+                metrics->count(metricCounter::PACKETS_DECODED, decoder.packetCount());
+                if(!decoder.finished())
+                {
+                    return ErrorCodes::InvalidReadOperation;
+                }
+
+                return std::nullopt;
+            }
+
+            // Raw or RLE pixels are decoded into a small block of rows. Every row is mirrored if needed and converted
+            // straight into its final position, so neither conversion nor reorientation costs a pass over the image.
+            std::optional<ErrorCodes> transformStoredPixels(std::ifstream& inputFile, const TGAHeader& header, const pixelFormat& storedFormat,
+                                                            std::uint8_t* data, const pixelFormat& format, const bool& normalizeOrigin,
+                                                            std::optional<StatisticsAccumulator>& statistics)
+            {
+                const std::size_t width = header.width;
+                const std::size_t height = header.height;
+                if(width == 0 || height == 0)
+                {
+                    return std::nullopt;
+                }
+
+                const std::size_t storedRowSize = width*bytesPerPixel(storedFormat);
+                const std::size_t outputRowSize = width*bytesPerPixel(format);
+                const auto reverseRowOrder = normalizeOrigin && (header.imagedescriptor & topOriginMask) == 0;
+                const auto reversePixelOrder = normalizeOrigin && (header.imagedescriptor & rightOriginMask) != 0;
+
+                const auto rowsPerBlock = std::min(height, std::max<std::size_t>(1, convertBlockPixels/width));
+                std::vector<std::uint8_t> rows(rowsPerBlock*storedRowSize);
+                std::vector<std::uint8_t> block;
+                const std::uint8_t* input{nullptr};
+                const std::uint8_t* inputEnd{nullptr};
 
-                    //Check if chunk is RAW
-                    if(!(chunkHeader & runLengthMask))
+                std::optional<RunLengthDecoder> decoder;
+                if(isCompressedFormat(header))
+                {
+                    block.resize(readBlockSize);
+                    decoder.emplace(bytesPerPixel(storedFormat), width*height);
+                }
+
+                for(std::size_t firstRow = 0; firstRow < height; firstRow += rowsPerBlock)
+                {
+                    const auto rowCount = std::min(rowsPerBlock, height - firstRow);
+
+                    if(!decoder.has_value())
+                    {
+                        if(!readBlock(inputFile, rows.data(), rowCount*storedRowSize))
+                        {
+                            return ErrorCodes::InvalidReadOperation;
+                        }
+                    }
+                    else
                     {
-                        ++chunkHeader;
-                        for(auto iter = 0; iter < chunkHeader; ++iter)
+                        auto output = rows.data();
+                        const auto outputEnd = output + rowCount*storedRowSize;
+                        while(true)
                         {
-                            inputFile.read(reinterpret_cast<char*>(&color), (header.bitsperpixel>>3));
-                            if(!inputFile.good())
+                            auto result = decodeRunLength(*decoder, input, inputEnd, output, outputEnd);
+                            if(result.has_value())
                             {
-                                return ErrorCodes::InvalidReadOperation;
+                                return result;
                             }
 
-                            for(auto i = 0; i < bytesPerPixel; ++i)
+                            if(output == outputEnd)
                             {
-                                data[currentByte++] = color.bgra[i];
+                                break;
                             }
-                            ++currentPixel;
 
-                            if(currentPixel > pixelCount)
+                            const auto bytesRead = readPartialBlock(inputFile, block.data(), block.size());
+                            if(bytesRead <= 0)
                             {
                                 return ErrorCodes::InvalidReadOperation;
                             }
+
+                            input = block.data();
+                            inputEnd = block.data() + bytesRead;
                         }
                     }
-                    else
+
+                    StageTimer timer{*metrics, loadStage::CONVERT};
+                    for(std::size_t index = 0; index < rowCount; ++index)
                     {
-                        //Handle RLE data
-                        chunkHeader -= maxDataLenghtRLE;
-                        inputFile.read(reinterpret_cast<char*>(&color.bgra), bytesPerPixel);
-                        if(!inputFile.good())
+                        const auto row = rows.data() + index*storedRowSize;
+                        if(reversePixelOrder)
                         {
-                            return ErrorCodes::InvalidReadOperation;
+                            reversePixels(row, width, bytesPerPixel(storedFormat));
                         }
 
-                        for(auto i = 0; i < chunkHeader; ++i)
+                        const auto outputRow = reverseRowOrder ? height - 1 - (firstRow + index) : firstRow + index;
+                        convertPixels(row, storedFormat, data + outputRow*outputRowSize, format, width);
+                        if(statistics.has_value())
                         {
-                            for(auto j = 0; j < bytesPerPixel; ++j)
-                            {
-                                data[currentByte++] = color.bgra[j];
-                            }
-                            ++currentPixel;
-
-                            if(currentPixel > pixelCount)
-                            {
-                                return ErrorCodes::InvalidReadOperation;
-                            }
+                            statistics->add(data + outputRow*outputRowSize, width);
                         }
                     }
                 }
 
-                return data;
+                if(decoder.has_value())
+                {
+                    metrics->count(metricCounter::PACKETS_DECODED, decoder->packetCount());
+                }
+
+                return std::nullopt;
             }
 
-            std::optional<ErrorCodes> compressRunLength(std::ofstream& outputFile, std::uint8_t* data, const TGAHeader& header)
+            std::optional<ErrorCodes> compressRunLength(const ByteSink& sink, const std::uint8_t* data, const TGAHeader& header)
             {
 
                 if(data == nullptr)
@@ -220,61 +1046,74 @@ namespace imageloader
                     return ErrorCodes::InvalidWriteOperation;
                 }
 
-                const auto pixelCount = header.width*header.height;
+                const std::size_t pixelCount = static_cast<std::size_t>(header.width)*header.height;
                 const auto bytesPerPixel = header.bitsperpixel >> 3;
-                auto currentPixel = 0;
-                bool isChunkRaw = true;
 
+                RunLengthEncoder encoder{bytesPerPixel};
+                std::vector<std::uint8_t> buffer;
+                buffer.reserve(writeBlockSize + maxChunkLength*bytesPerPixel + 1);
+
+                std::size_t currentPixel = 0;
                 while(currentPixel < pixelCount)
                 {
-                    auto runLengthNumber = 1;
-                    auto currentByte = currentPixel*bytesPerPixel;
-                    auto chunkStart = currentPixel*bytesPerPixel;
+                    currentPixel = encoder.encode(data, pixelCount, currentPixel, buffer, writeBlockSize);
 
-                    while(currentPixel + runLengthNumber < pixelCount && runLengthNumber < maxChunkLength)
+                    if(!sink(buffer.data(), buffer.size()))
                     {
-                        bool isSuccessorEqual = true;
-                        for(auto iter = 0; isSuccessorEqual && iter < bytesPerPixel; ++iter)
-                        {
-                            isSuccessorEqual = data[currentByte+iter] == data[currentByte+bytesPerPixel+iter];
-                        }
-                        currentByte += bytesPerPixel;
-                        if(runLengthNumber == 1)
-                        {
-                            // If chunk is RAw, further checks will terminate the loop, this one just sets the RAW flag to proper state
-                            isChunkRaw = !isSuccessorEqual;
-                        }
+                        return ErrorCodes::InvalidWriteOperation;
+                    }
+                    buffer.clear();
+                }
 
-                        //Handle first occurence of a similar chunk, while RAW data is being processed
-                        if(isChunkRaw && isSuccessorEqual)
-                        {
-                            --runLengthNumber;
-                            break;
-                        }
+                return std::nullopt;
+            }
 
-                        if(!isChunkRaw && !isSuccessorEqual)
-                        {
-                            break;
-                        }
+            // Every band of rows is encoded into its own buffer, packets never cross band boundaries.
+            // Bands are processed in rounds, so memory stays bounded by a few bands per worker.
+            std::optional<ErrorCodes> compressRunLengthParallel(const ByteSink& sink, const std::uint8_t* data, const TGAHeader& header)
+            {
+                if(data == nullptr)
+                {
+                    return ErrorCodes::InvalidWriteOperation;
+                }
 
-                        ++runLengthNumber;
-                    }
+                const std::size_t width = header.width;
+                const std::size_t height = header.height;
+                const auto bytesPerPixel = header.bitsperpixel >> 3;
+                if(width == 0 || height == 0)
+                {
+                    return std::nullopt;
+                }
+
+                auto& pool = workerPool();
+                const auto rowsPerBand = std::max<std::size_t>(1, (minBandPixels + width - 1)/width);
+                const auto bandCount = (height + rowsPerBand - 1)/rowsPerBand;
+                const auto bandsPerRound = static_cast<std::size_t>(pool.workerCount())*2;
 
-                    currentPixel += runLengthNumber;
+                std::vector<std::vector<std::uint8_t>> buffers(std::min(bandsPerRound, bandCount));
+
+                for(std::size_t firstBand = 0; firstBand < bandCount; firstBand += buffers.size())
+                {
+                    const auto roundBands = std::min(buffers.size(), bandCount - firstBand);
 
-                    const auto chunkStatusValue = isChunkRaw ? runLengthNumber-1 : runLengthNumber + maxDataLenghtRLE;
-                    outputFile.put(chunkStatusValue);
-                    if(!outputFile.good())
+                    pool.parallelFor(roundBands, [&](const std::size_t& index)
                     {
-                        return ErrorCodes::InvalidWriteOperation;
-                    }
+                        const auto firstRow = (firstBand + index)*rowsPerBand;
+                        const auto bandPixels = std::min(rowsPerBand, height - firstRow)*width;
+
+                        auto& buffer = buffers[index];
+                        buffer.clear();
+
+                        RunLengthEncoder encoder{bytesPerPixel};
+                        encoder.encode(data + firstRow*width*bytesPerPixel, bandPixels, 0, buffer, std::numeric_limits<std::size_t>::max());
+                    });
 
-                    //In case of a RAW data, write bigger chunk, as size number of raw chunks * bytesPerPixel
-                    const auto dataToBeWriten = isChunkRaw ? runLengthNumber*bytesPerPixel : bytesPerPixel;
-                    outputFile.write(reinterpret_cast<char*>(data+chunkStart), dataToBeWriten);
-                    if(!outputFile.good())
+                    for(std::size_t index = 0; index < roundBands; ++index)
                     {
-                        return ErrorCodes::InvalidWriteOperation;
+                        if(!sink(buffers[index].data(), buffers[index].size()))
+                        {
+                            return ErrorCodes::InvalidWriteOperation;
+                        }
                     }
                 }
 
@@ -282,29 +1121,118 @@ namespace imageloader
             }
     };
 
-    TGAImageLoader::TGAImageLoader() : d_ptr{new TGAImageLoaderImpl}
+    TGAImageLoader::TGAImageLoader() : d_ptr{new TGAImageLoaderImpl{0}}
+    {
+
+    }
+
+    TGAImageLoader::TGAImageLoader(const unsigned int& workerCount) : d_ptr{new TGAImageLoaderImpl{workerCount}}
     {
 
     }
 
     std::variant<TGAImage*, ErrorCodes> TGAImageLoader::loadImage(const std::string_view& imagePath)
     {
-        if(!std::filesystem::exists(imagePath))
+        if(!d_ptr->pathExists(imagePath))
         {
             return ErrorCodes::InvalidPath;
         }
 
-        return d_ptr->loadImage(imagePath);
+        return d_ptr->loadImage(imagePath, StatisticsSink{});
     }
 
-    std::variant<std::string, ErrorCodes> TGAImageLoader::storeImage(const std::string_view& imagePath, const TGAImage& image)
+    std::variant<TGAImage*, ErrorCodes> TGAImageLoader::loadImage(const std::string_view& imagePath, const loadMode& mode)
     {
-        if(!verifyDirectoryExistence(imagePath))
+        if(loadMode::COPY == mode)
+        {
+            return loadImage(imagePath);
+        }
+
+        if(loadMode::LAZY == mode)
+        {
+            return loadImage(imagePath, LoadOptions{mode, std::nullopt, false, nullptr});
+        }
+
+        if(!d_ptr->pathExists(imagePath))
+        {
+            return ErrorCodes::InvalidPath;
+        }
+
+        return d_ptr->loadMappedImage(imagePath, StatisticsSink{});
+    }
+
+    std::variant<TGAImage*, ErrorCodes> TGAImageLoader::loadImage(const std::string_view& imagePath, const pixelFormat& format)
+    {
+        return loadImage(imagePath, LoadOptions{loadMode::COPY, format, false, nullptr});
+    }
+
+    std::variant<TGAImage*, ErrorCodes> TGAImageLoader::loadImage(const std::string_view& imagePath, const LoadOptions& options)
+    {
+        if(!d_ptr->pathExists(imagePath))
+        {
+            return ErrorCodes::InvalidPath;
+        }
+
+        return d_ptr->loadImage(imagePath, options);
+    }
+
+    std::vector<std::variant<TGAImage*, ErrorCodes>> TGAImageLoader::loadImages(const std::vector<std::string>& imagePaths)
+    {
+        return loadImages(imagePaths, loadMode::COPY);
+    }
+
+    std::vector<std::variant<TGAImage*, ErrorCodes>> TGAImageLoader::loadImages(const std::vector<std::string>& imagePaths,
+                                                                                const loadMode& mode)
+    {
+        return loadImages(imagePaths, LoadOptions{mode, std::nullopt, false, nullptr});
+    }
+
+    std::vector<std::variant<TGAImage*, ErrorCodes>> TGAImageLoader::loadImages(const std::vector<std::string>& imagePaths,
+                                                                                const LoadOptions& options)
+    {
+        const auto plainCopy = loadMode::COPY == options.mode && !options.format.has_value() && !options.normalizeOrigin;
+        if(d_ptr->io && plainCopy)
+        {
+            return d_ptr->loadImagesAsync(imagePaths, options.statistics);
+        }
+
+        std::vector<std::variant<TGAImage*, ErrorCodes>> results(imagePaths.size(), ErrorCodes::InvalidReadOperation);
+
+        // Every file is a separate task, so a slow file never holds back a whole slice of the batch
+        d_ptr->workerPool().parallelFor(imagePaths.size(), [&](const std::size_t& index)
+        {
+            results[index] = loadImage(imagePaths[index], options);
+        });
+
+        return results;
+    }
+
+    std::variant<ImageInfo, ErrorCodes> TGAImageLoader::probeImage(const std::string_view& imagePath)
+    {
+        if(!d_ptr->pathExists(imagePath))
         {
             return ErrorCodes::InvalidPath;
         }
 
-        return d_ptr->storeImage(imagePath, image);
+        return d_ptr->probeImage(imagePath);
+    }
+
+    std::vector<std::variant<ImageInfo, ErrorCodes>> TGAImageLoader::probeImages(const std::vector<std::string>& imagePaths)
+    {
+        std::vector<std::variant<ImageInfo, ErrorCodes>> results(imagePaths.size(), ErrorCodes::InvalidReadOperation);
+
+        // Probes mostly wait for the filesystem, so the workers keep several requests in flight
+        d_ptr->workerPool().parallelFor(imagePaths.size(), [&](const std::size_t& index)
+        {
+            results[index] = probeImage(imagePaths[index]);
+        });
+
+        return results;
+    }
+
+    std::variant<std::string, ErrorCodes> TGAImageLoader::storeImage(const std::string_view& imagePath, const TGAImage& image)
+    {
+        return storeImage(imagePath, image, compressionStatus::NO);
     }
 
     std::variant<std::string, ErrorCodes> TGAImageLoader::storeImage(const std::string_view& imagePath, const TGAImage& image,
@@ -315,21 +1243,129 @@ namespace imageloader
             return ErrorCodes::InvalidPath;
         }
 
+        return d_ptr->storeImage(imagePath, image, status);
+    }
+
+    std::vector<std::variant<std::string, ErrorCodes>> TGAImageLoader::storeImages(const std::vector<std::string>& imagePaths,
+                                                                                   const std::vector<const TGAImage*>& images)
+    {
+        return storeImages(imagePaths, images, compressionStatus::NO);
+    }
+
+    std::vector<std::variant<std::string, ErrorCodes>> TGAImageLoader::storeImages(const std::vector<std::string>& imagePaths,
+                                                                                   const std::vector<const TGAImage*>& images,
+                                                                                   const compressionStatus& status)
+    {
+        if(d_ptr->io)
+        {
+            return d_ptr->storeImagesAsync(imagePaths, images, status, [this](const std::string_view& imagePath)
+            {
+                return verifyDirectoryExistence(imagePath);
+            });
+        }
+
+        // Paths without an image fail
+        std::vector<std::variant<std::string, ErrorCodes>> results(imagePaths.size(), ErrorCodes::InvalidWriteOperation);
+
+        d_ptr->workerPool().parallelFor(std::min(imagePaths.size(), images.size()), [&](const std::size_t& index)
+        {
+            if(images[index] != nullptr)
+            {
+                results[index] = storeImage(imagePaths[index], *images[index], status);
+            }
+        });
+
+        return results;
+    }
+
+    ioBackend TGAImageLoader::setIOBackend(const ioBackend& backend, const unsigned int& queueDepth)
+    {
+        d_ptr->io = AsyncFileIO::create(backend, queueDepth);
+        return d_ptr->io ? d_ptr->io->backend() : ioBackend::BLOCKING;
+    }
+
+    void TGAImageLoader::setPixelAllocator(std::shared_ptr<PixelAllocator> allocator)
+    {
+        d_ptr->allocator = allocator ? std::move(allocator) : defaultPixelAllocator();
+    }
+
+    std::variant<TGAImage*, ErrorCodes> TGAImageLoader::decode(const std::uint8_t* data, const std::size_t& size)
+    {
+        std::optional<StatisticsAccumulator> statistics;
+        return d_ptr->decodeImage(data, size, statistics, true);
+    }
+
+    std::optional<ErrorCodes> TGAImageLoader::encode(const TGAImage& image, std::vector<std::uint8_t>& output)
+    {
+        return encode(image, output, compressionStatus::NO);
+    }
+
+    std::optional<ErrorCodes> TGAImageLoader::encode(const TGAImage& image, std::vector<std::uint8_t>& output,
+                                                     const compressionStatus& status)
+    {
         if(compressionStatus::NO == status)
         {
-            return storeImage(imagePath, image);
+            output.reserve(output.size() + sizeof(TGAHeader) + image.dataSize());
         }
 
-        return d_ptr->storeCompressedImage(imagePath, image);
+        return encode(image, [&output](const std::uint8_t* data, const std::size_t& size)
+        {
+            output.insert(output.end(), data, data + size);
+            return true;
+        }, status);
+    }
+
+    std::optional<ErrorCodes> TGAImageLoader::encode(const TGAImage& image, const ByteSink& sink, const compressionStatus& status)
+    {
+        return d_ptr->encodeImage(image, sink, status);
+    }
+
+    void TGAImageLoader::enableMetrics(const bool& enabled)
+    {
+        d_ptr->metrics->enableMetrics(enabled);
+    }
+
+    LoaderMetrics TGAImageLoader::metrics() const
+    {
+        return d_ptr->metrics->snapshot();
+    }
+
+    void TGAImageLoader::resetMetrics()
+    {
+        d_ptr->metrics->reset();
     }
 
+    void TGAImageLoader::enableTracing(const bool& enabled)
+    {
+        d_ptr->metrics->enableTracing(enabled);
+    }
+
+    std::optional<ErrorCodes> TGAImageLoader::writeTrace(const std::string_view& tracePath) const
+    {
+        return d_ptr->metrics->writeTrace(tracePath);
+    }
 
     bool TGAImageLoader::verifyDirectoryExistence(const std::string_view& imagePath)
     {
+        StageTimer timer{*d_ptr->metrics, loadStage::PATH_CHECK};
+
         //Start of the string + position where '/' is located
         const auto directoryPath = imagePath.substr(0, imagePath.find_last_of('/') + 1);
 
-        return std::filesystem::exists( directoryPath) ? true : std::filesystem::create_directories(directoryPath);
+        // A bare file name is stored in the working directory
+        if(directoryPath.empty())
+        {
+            return true;
+        }
+
+        // Batch stores may create the same directory concurrently, losing that race is no error
+        std::error_code error;
+        if(std::filesystem::exists(directoryPath, error))
+        {
+            return true;
+        }
+
+        return std::filesystem::create_directories(directoryPath, error) || std::filesystem::is_directory(directoryPath, error);
     }
 
     TGAImageLoader::~TGAImageLoader()
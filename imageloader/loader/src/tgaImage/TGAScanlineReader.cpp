@@ -0,0 +1,314 @@
+#include "tgaImage/TGAScanlineReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Orientation.hpp"
+#include "RunLength.hpp"
+#include "TGAFormat.hpp"
+
+namespace imageloader
+{
+    // Compressed data is read from the file in blocks of this size
+    constexpr auto streamBlockSize = 256*1024;
+
+    class TGAScanlineReaderImpl
+    {
+        public:
+            // Position in the RLE stream at which a stored row starts
+            struct Checkpoint
+            {
+                std::uint64_t fileOffset{0};
+                RunLengthDecoder decoder;
+            };
+
+            std::ifstream inputFile;
+            TGAHeader header{};
+            bool isOpen{false};
+            std::size_t rowSize{0};
+            std::size_t bytesPerPixel{0};
+            std::uint64_t dataOffset{0};
+            int nextRow{0};
+
+            std::vector<std::uint8_t> block;
+            const std::uint8_t* blockInput{nullptr};
+            const std::uint8_t* blockEnd{nullptr};
+            std::uint64_t nextReadOffset{0};
+            std::optional<RunLengthDecoder> decoder;
+            // Stored rows already produced by the forward decoder
+            int decodedRows{0};
+            std::vector<Checkpoint> checkpoints;
+            std::vector<std::uint8_t> rowBuffer;
+
+            bool isTopOrigin() const
+            {
+                return (header.imagedescriptor & topOriginMask) != 0;
+            }
+
+            bool isRightOrigin() const
+            {
+                return (header.imagedescriptor & rightOriginMask) != 0;
+            }
+
+            std::uint64_t inputOffset() const
+            {
+                return nextReadOffset - static_cast<std::uint64_t>(blockEnd - blockInput);
+            }
+
+            void seek(const std::uint64_t& offset)
+            {
+                inputFile.clear();
+                inputFile.seekg(static_cast<std::streamoff>(offset));
+                nextReadOffset = offset;
+                blockInput = block.data();
+                blockEnd = block.data();
+            }
+
+            // Decodes rowCount stored rows, starting at the current position of the RLE stream
+            std::optional<ErrorCodes> decodeRows(std::uint8_t* output, const int& rowCount)
+            {
+                const auto outputEnd = output + rowCount*rowSize;
+                while(true)
+                {
+                    // Packets carried over from the previous row may complete the output without new input
+                    auto result = decoder->decode(blockInput, blockEnd, output, outputEnd);
+                    if(result.has_value())
+                    {
+                        return result;
+                    }
+
+                    if(output == outputEnd)
+                    {
+                        break;
+                    }
+
+                    inputFile.read(reinterpret_cast<char*>(block.data()), block.size());
+                    const auto bytesRead = inputFile.gcount();
+                    if(bytesRead <= 0)
+                    {
+                        return ErrorCodes::InvalidReadOperation;
+                    }
+
+                    nextReadOffset += bytesRead;
+                    blockInput = block.data();
+                    blockEnd = block.data() + bytesRead;
+                }
+
+                decodedRows += rowCount;
+                return std::nullopt;
+            }
+
+            // Bottom-left images are read backwards, so every row start is recorded once up front
+            std::optional<ErrorCodes> buildCheckpoints()
+            {
+                checkpoints.reserve(header.height);
+                for(auto row = 0; row < header.height; ++row)
+                {
+                    checkpoints.push_back(Checkpoint{inputOffset(), *decoder});
+                    auto result = decodeRows(rowBuffer.data(), 1);
+                    if(result.has_value())
+                    {
+                        return result;
+                    }
+                }
+
+                return std::nullopt;
+            }
+
+            std::optional<ErrorCodes> readStoredRows(std::uint8_t* output, const int& firstRow, const int& rowCount)
+            {
+                if(isUncompressedFormat(header))
+                {
+                    inputFile.clear();
+                    inputFile.seekg(static_cast<std::streamoff>(dataOffset + firstRow*rowSize));
+                    inputFile.read(reinterpret_cast<char*>(output), rowCount*rowSize);
+                    if(!inputFile.good())
+                    {
+                        return ErrorCodes::InvalidReadOperation;
+                    }
+
+                    return std::nullopt;
+                }
+
+                if(decodedRows != firstRow)
+                {
+                    const auto& checkpoint = checkpoints.at(firstRow);
+                    seek(checkpoint.fileOffset);
+                    decoder = checkpoint.decoder;
+                    decodedRows = firstRow;
+                }
+
+                return decodeRows(output, rowCount);
+            }
+    };
+
+    TGAScanlineReader::TGAScanlineReader() : d_ptr{new TGAScanlineReaderImpl}
+    {
+
+    }
+
+    TGAScanlineReader::~TGAScanlineReader()
+    {
+
+    }
+
+    std::optional<ErrorCodes> TGAScanlineReader::open(const std::string_view& imagePath)
+    {
+        close();
+
+        // Like the loader, a path the filesystem refuses to look at does not exist
+        std::error_code error;
+        if(!std::filesystem::exists(imagePath, error))
+        {
+            return ErrorCodes::InvalidPath;
+        }
+
+        auto& impl = *d_ptr;
+        impl.inputFile.open(std::string{imagePath}, std::ios::binary);
+        if(!impl.inputFile.is_open())
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        impl.inputFile.read(reinterpret_cast<char*>(&impl.header), sizeof(impl.header));
+        if(!impl.inputFile.good())
+        {
+            close();
+            return ErrorCodes::InvalidReadOperation;
+        }
+
+        impl.bytesPerPixel = impl.header.bitsperpixel>>3;
+        if((!isUncompressedFormat(impl.header) && !isCompressedFormat(impl.header)) ||
+           impl.bytesPerPixel == 0 || impl.bytesPerPixel > 4)
+        {
+            close();
+            return ErrorCodes::UnsupportedFormat;
+        }
+
+        impl.rowSize = impl.header.width*impl.bytesPerPixel;
+        impl.dataOffset = pixelDataOffset(impl.header);
+        impl.rowBuffer.resize(impl.rowSize);
+        impl.isOpen = true;
+
+        if(isCompressedFormat(impl.header))
+        {
+            impl.block.resize(streamBlockSize);
+            impl.seek(impl.dataOffset);
+            impl.decoder.emplace(static_cast<int>(impl.bytesPerPixel), static_cast<std::size_t>(impl.header.width)*impl.header.height);
+
+            if(!impl.isTopOrigin() && impl.rowSize != 0)
+            {
+                auto result = impl.buildCheckpoints();
+                if(result.has_value())
+                {
+                    close();
+                    return result;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void TGAScanlineReader::close()
+    {
+        auto& impl = *d_ptr;
+        if(impl.inputFile.is_open())
+        {
+            impl.inputFile.close();
+        }
+        impl.inputFile.clear();
+
+        impl.header = TGAHeader{};
+        impl.isOpen = false;
+        impl.rowSize = 0;
+        impl.bytesPerPixel = 0;
+        impl.nextRow = 0;
+        impl.decodedRows = 0;
+        impl.decoder.reset();
+        impl.checkpoints.clear();
+        impl.block.clear();
+        impl.rowBuffer.clear();
+        impl.blockInput = nullptr;
+        impl.blockEnd = nullptr;
+    }
+
+    TGAHeader TGAScanlineReader::header() const
+    {
+        return d_ptr->header;
+    }
+
+    int TGAScanlineReader::width() const
+    {
+        return d_ptr->header.width;
+    }
+
+    int TGAScanlineReader::height() const
+    {
+        return d_ptr->header.height;
+    }
+
+    int TGAScanlineReader::bitsPerPixel() const
+    {
+        return static_cast<int>(d_ptr->bytesPerPixel);
+    }
+
+    std::size_t TGAScanlineReader::rowSize() const
+    {
+        return d_ptr->rowSize;
+    }
+
+    int TGAScanlineReader::currentRow() const
+    {
+        return d_ptr->nextRow;
+    }
+
+    std::variant<int, ErrorCodes> TGAScanlineReader::readRows(std::uint8_t* output, const int& rowCount)
+    {
+        auto& impl = *d_ptr;
+        if(!impl.isOpen)
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        if(output == nullptr || rowCount < 0)
+        {
+            return ErrorCodes::InvalidReadOperation;
+        }
+
+        const auto rows = std::min(rowCount, impl.header.height - impl.nextRow);
+        if(rows <= 0 || impl.rowSize == 0)
+        {
+            impl.nextRow += std::max(rows, 0);
+            return std::max(rows, 0);
+        }
+
+        // Bottom-left images store the requested band as a contiguous block of rows in reverse order
+        const auto firstStoredRow = impl.isTopOrigin() ? impl.nextRow : impl.header.height - impl.nextRow - rows;
+        auto result = impl.readStoredRows(output, firstStoredRow, rows);
+        if(result.has_value())
+        {
+            return result.value();
+        }
+
+        if(!impl.isTopOrigin())
+        {
+            reverseRows(ImageView{output, impl.header.width, rows, static_cast<int>(impl.bytesPerPixel)});
+        }
+
+        if(impl.isRightOrigin())
+        {
+            for(auto row = 0; row < rows; ++row)
+            {
+                reversePixels(output + row*impl.rowSize, impl.header.width, static_cast<int>(impl.bytesPerPixel));
+            }
+        }
+
+        impl.nextRow += rows;
+        return rows;
+    }
+} // namespace imageloader
@@ -0,0 +1,201 @@
+#include "tgaImage/TGAScanlineWriter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "RunLength.hpp"
+#include "TGAFormat.hpp"
+
+namespace imageloader
+{
+    // Encoded data is written to the file in blocks of this size
+    constexpr std::size_t streamWriteBlockSize = 1024*1024;
+
+    class TGAScanlineWriterImpl
+    {
+        public:
+            std::ofstream outputFile;
+            std::string imagePath;
+            TGAHeader header{};
+            bool isOpen{false};
+            bool isCompressed{false};
+            std::size_t rowSize{0};
+            int bytesPerPixel{0};
+            int nextRow{0};
+            std::vector<std::uint8_t> buffer;
+
+            std::optional<ErrorCodes> flush()
+            {
+                if(buffer.empty())
+                {
+                    return std::nullopt;
+                }
+
+                outputFile.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+                buffer.clear();
+                if(!outputFile.good())
+                {
+                    return ErrorCodes::InvalidWriteOperation;
+                }
+
+                return std::nullopt;
+            }
+
+            void discard()
+            {
+                outputFile.close();
+                // Runs from the destructor as well, a file that cannot be removed is left behind
+                std::error_code error;
+                std::filesystem::remove(imagePath, error);
+                isOpen = false;
+            }
+    };
+
+    TGAScanlineWriter::TGAScanlineWriter() : d_ptr{new TGAScanlineWriterImpl}
+    {
+
+    }
+
+    TGAScanlineWriter::~TGAScanlineWriter()
+    {
+        if(d_ptr->isOpen)
+        {
+            auto result = close();
+            static_cast<void>(result);
+        }
+    }
+
+    std::optional<ErrorCodes> TGAScanlineWriter::open(const std::string_view& imagePath, const TGAHeader& header,
+                                                      const compressionStatus& status)
+    {
+        if(d_ptr->isOpen)
+        {
+            auto result = close();
+            static_cast<void>(result);
+        }
+
+        auto& impl = *d_ptr;
+        impl.bytesPerPixel = header.bitsperpixel>>3;
+        if(impl.bytesPerPixel == 0 || impl.bytesPerPixel > 4)
+        {
+            return ErrorCodes::UnsupportedFormat;
+        }
+
+        //Start of the string + position where '/' is located
+        const auto directoryPath = imagePath.substr(0, imagePath.find_last_of('/') + 1);
+        std::error_code error;
+        if(!directoryPath.empty() && !std::filesystem::exists(directoryPath, error) &&
+           !std::filesystem::create_directories(directoryPath, error) && !std::filesystem::is_directory(directoryPath, error))
+        {
+            return ErrorCodes::InvalidPath;
+        }
+
+        impl.imagePath = std::string{imagePath};
+        impl.outputFile.open(impl.imagePath, std::ios::binary | std::ios::out);
+        if(!impl.outputFile.is_open())
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        impl.isOpen = true;
+        impl.isCompressed = compressionStatus::NO != status;
+        impl.header = storedHeader(header, impl.isCompressed);
+        impl.header.imagedescriptor = static_cast<std::uint8_t>((impl.header.imagedescriptor & ~rightOriginMask) | topOriginMask);
+        impl.rowSize = static_cast<std::size_t>(impl.header.width)*impl.bytesPerPixel;
+        impl.nextRow = 0;
+        impl.buffer.clear();
+        impl.buffer.reserve(streamWriteBlockSize + impl.rowSize + impl.rowSize/maxChunkLength + 1);
+
+        const auto headerBytes = reinterpret_cast<const std::uint8_t*>(&impl.header);
+        impl.buffer.insert(impl.buffer.end(), headerBytes, headerBytes + sizeof(impl.header));
+
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> TGAScanlineWriter::writeRows(const std::uint8_t* rows, const int& rowCount)
+    {
+        auto& impl = *d_ptr;
+        if(!impl.isOpen)
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        if(rows == nullptr || rowCount < 0 || rowCount > impl.header.height - impl.nextRow)
+        {
+            return ErrorCodes::IndexOutOfRange;
+        }
+
+        for(auto row = 0; row < rowCount; ++row)
+        {
+            const auto rowData = rows + row*impl.rowSize;
+            if(impl.isCompressed)
+            {
+                RunLengthEncoder encoder{impl.bytesPerPixel};
+                encoder.encode(rowData, impl.header.width, 0, impl.buffer, std::numeric_limits<std::size_t>::max());
+            }
+            else
+            {
+                impl.buffer.insert(impl.buffer.end(), rowData, rowData + impl.rowSize);
+            }
+
+            if(impl.buffer.size() >= streamWriteBlockSize)
+            {
+                auto result = impl.flush();
+                if(result.has_value())
+                {
+                    impl.discard();
+                    return result;
+                }
+            }
+        }
+
+        impl.nextRow += rowCount;
+        return std::nullopt;
+    }
+
+    std::optional<ErrorCodes> TGAScanlineWriter::close()
+    {
+        auto& impl = *d_ptr;
+        if(!impl.isOpen)
+        {
+            return ErrorCodes::UnableToOpenImage;
+        }
+
+        if(impl.nextRow != impl.header.height)
+        {
+            impl.discard();
+            return ErrorCodes::InvalidWriteOperation;
+        }
+
+        auto result = impl.flush();
+        if(result.has_value())
+        {
+            impl.discard();
+            return result;
+        }
+
+        // The last buffered bytes reach the file here, so a full disk may only show up now
+        impl.outputFile.close();
+        if(impl.outputFile.fail())
+        {
+            impl.discard();
+            return ErrorCodes::InvalidWriteOperation;
+        }
+
+        impl.isOpen = false;
+        return std::nullopt;
+    }
+
+    std::size_t TGAScanlineWriter::rowSize() const
+    {
+        return d_ptr->rowSize;
+    }
+
+    int TGAScanlineWriter::currentRow() const
+    {
+        return d_ptr->nextRow;
+    }
+} // namespace imageloader
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace utils::threading
+{
+    // Lock-free bounded multi-producer multi-consumer queue (Dmitry Vyukov's design). Every slot carries a sequence
+    // number telling whether it is free or filled for the current lap, so producers and consumers claim slots with a
+    // single compare-exchange on their position and never wait for each other. Slots are written and read in place,
+    // values keep their storage (e.g. string capacity) from one lap to the next.
+    template<typename T>
+    class BoundedQueue
+    {
+        public:
+            // capacity is rounded up to a power of two
+            explicit BoundedQueue(const std::size_t& capacity) :
+                        slotCount{roundUpToPowerOfTwo(capacity)},
+                        slots{new Slot[slotCount]}
+            {
+                for(std::size_t index = 0; index < slotCount; ++index)
+                {
+                    slots[index].sequence.store(index, std::memory_order_relaxed);
+                }
+            }
+
+            BoundedQueue(const BoundedQueue&) = delete;
+            BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+            std::size_t capacity() const
+            {
+                return slotCount;
+            }
+
+            // Calls write(T& value) on a free slot, returns false without calling it if the queue is full
+            template<typename Function>
+            bool tryPush(Function&& write)
+            {
+                auto position = enqueuePosition.load(std::memory_order_relaxed);
+                while(true)
+                {
+                    auto& slot = slots[position & (slotCount - 1)];
+                    const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                    const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+                    if(difference == 0)
+                    {
+                        if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            write(slot.value);
+                            slot.sequence.store(position + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if(difference < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = enqueuePosition.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            // Calls read(T& value) on the oldest filled slot, returns false without calling it if the queue is empty
+            template<typename Function>
+            bool tryPop(Function&& read)
+            {
+                auto position = dequeuePosition.load(std::memory_order_relaxed);
+                while(true)
+                {
+                    auto& slot = slots[position & (slotCount - 1)];
+                    const auto sequence = slot.sequence.load(std::memory_order_acquire);
+                    const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+
+                    if(difference == 0)
+                    {
+                        if(dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            read(slot.value);
+                            slot.sequence.store(position + slotCount, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if(difference < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = dequeuePosition.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+        private:
+            // Slots and positions live on separate cache lines, so producers and consumers do not share them
+            static constexpr std::size_t cacheLineSize = 64;
+
+            struct alignas(cacheLineSize) Slot
+            {
+                std::atomic<std::size_t> sequence{0};
+                T value{};
+            };
+
+            static std::size_t roundUpToPowerOfTwo(const std::size_t& value)
+            {
+                std::size_t result = 2;
+                while(result < value)
+                {
+                    result <<= 1;
+                }
+
+                return result;
+            }
+
+        private:
+            std::size_t slotCount{0};
+            std::unique_ptr<Slot[]> slots;
+            alignas(cacheLineSize) std::atomic<std::size_t> enqueuePosition{0};
+            alignas(cacheLineSize) std::atomic<std::size_t> dequeuePosition{0};
+    };
+} // namespace utils::threading
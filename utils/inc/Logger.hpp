@@ -1,43 +1,115 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string_view>
 
 #include "spdlog/spdlog.h"
 #include "Constants.hpp"
 
+// Messages below this spdlog level are removed at compile time together with the formatting of their arguments,
+// set through the UTILS_LOG_LEVEL CMake cache variable
+#if !defined(UTILS_LOGGER_MIN_LEVEL)
+#define UTILS_LOGGER_MIN_LEVEL SPDLOG_LEVEL_DEBUG
+#endif
+
 namespace utils::logger
 {
     void setup(const std::string_view& level);
     void setup(const utils::constants::LogLevels& level);
 
+    // From here on messages are formatted by the calling thread and handed to a background thread through a lock-free
+    // queue, the background thread writes them to the default spdlog logger. Logging never blocks: while queueCapacity
+    // messages are pending, further messages are dropped and counted. Must not be called while other threads log.
+    void startAsync(const std::size_t& queueCapacity = 8192);
+    // Writes all pending messages and returns to synchronous logging, also called at exit
+    void stopAsync();
+    // Blocks until every message logged so far is written
+    void flush();
+    // Messages dropped because the queue was full
+    std::uint64_t droppedMessages();
+
+    namespace detail
+    {
+        constexpr bool isCompiledIn(const spdlog::level::level_enum& level)
+        {
+            return static_cast<int>(level) >= UTILS_LOGGER_MIN_LEVEL;
+        }
+
+        bool isAsync();
+        void enqueue(const spdlog::level::level_enum& level, const std::string_view& message);
+
+        template<typename Message, typename... Args>
+        void log(const spdlog::level::level_enum& level, Message&& msg, Args&&... args)
+        {
+            if(!isAsync())
+            {
+                spdlog::log(level, std::forward<Message>(msg), std::forward<Args>(args)...);
+                return;
+            }
+
+            // Runtime disabled levels are skipped before anything is formatted
+            if(!spdlog::should_log(level))
+            {
+                return;
+            }
+
+            if constexpr(sizeof...(Args) == 0)
+            {
+                enqueue(level, std::string_view{msg});
+            }
+            else
+            {
+                fmt::memory_buffer buffer;
+                fmt::vformat_to(std::back_inserter(buffer), fmt::string_view{std::string_view{msg}}, fmt::make_format_args(args...));
+                enqueue(level, std::string_view{buffer.data(), buffer.size()});
+            }
+        }
+    } // namespace detail
 
     template<typename Message, typename... Args >
-    void errorMessage(Message&& msg, Args&&... args )
+    void errorMessage([[maybe_unused]] Message&& msg, [[maybe_unused]] Args&&... args)
     {
-        spdlog::error(std::forward<Message>(msg), std::forward<Args>(args)...);
+        if constexpr(detail::isCompiledIn(spdlog::level::err))
+        {
+            detail::log(spdlog::level::err, std::forward<Message>(msg), std::forward<Args>(args)...);
+        }
     }
 
     template<typename Message, typename... Args >
-    void criticalMessage(Message&& msg, Args&&... args )
+    void criticalMessage([[maybe_unused]] Message&& msg, [[maybe_unused]] Args&&... args)
     {
-        spdlog::critical(std::forward<Message>(msg), std::forward<Args>(args)...);
+        if constexpr(detail::isCompiledIn(spdlog::level::critical))
+        {
+            detail::log(spdlog::level::critical, std::forward<Message>(msg), std::forward<Args>(args)...);
+        }
     }
 
     template<typename Message, typename... Args>
-    void warningMessage(Message&& msg, Args&&... args)
+    void warningMessage([[maybe_unused]] Message&& msg, [[maybe_unused]] Args&&... args)
     {
-        spdlog::warn(std::forward<Message>(msg), std::forward<Args>(args)...);
+        if constexpr(detail::isCompiledIn(spdlog::level::warn))
+        {
+            detail::log(spdlog::level::warn, std::forward<Message>(msg), std::forward<Args>(args)...);
+        }
     }
 
     template<typename Message, typename... Args>
-    void debugMessage(Message& msg, Args&&... args)
+    void debugMessage([[maybe_unused]] Message&& msg, [[maybe_unused]] Args&&... args)
     {
-        spdlog::debug(std::forward<Message>(msg), std::forward<Args>(args)...);
+        if constexpr(detail::isCompiledIn(spdlog::level::debug))
+        {
+            detail::log(spdlog::level::debug, std::forward<Message>(msg), std::forward<Args>(args)...);
+        }
     }
 
     template<typename Message, typename... Args>
-    void infoMessage(Message&& msg, Args&&... args)
+    void infoMessage([[maybe_unused]] Message&& msg, [[maybe_unused]] Args&&... args)
     {
-        spdlog::info(std::forward<Message>(msg), std::forward<Args>(args)...);
+        if constexpr(detail::isCompiledIn(spdlog::level::info))
+        {
+            detail::log(spdlog::level::info, std::forward<Message>(msg), std::forward<Args>(args)...);
+        }
     }
-}
\ No newline at end of file
+}
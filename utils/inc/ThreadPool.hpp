@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace utils::threading
+{
+    class ThreadPool
+    {
+        public:
+            // workerCount of 0 selects std::thread::hardware_concurrency()
+            explicit ThreadPool(const unsigned int& workerCount);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            unsigned int workerCount() const;
+            void submit(std::function<void()> task);
+
+            // Calls function(index) for every index in [0, count) and blocks until all of them are done.
+            // The calling thread takes part in the work, so it is safe to call from inside a worker.
+            template<typename Function>
+            void parallelFor(const std::size_t& count, Function&& function)
+            {
+                if(count == 0)
+                {
+                    return;
+                }
+
+                if(count == 1 || workers.size() <= 1)
+                {
+                    for(std::size_t index = 0; index < count; ++index)
+                    {
+                        function(index);
+                    }
+                    return;
+                }
+
+                auto state = std::make_shared<ParallelForState>();
+                state->count = count;
+                state->function = [&function](const std::size_t& index){ function(index); };
+
+                const auto helperCount = std::min<std::size_t>(workers.size(), count) - 1;
+                for(std::size_t helper = 0; helper < helperCount; ++helper)
+                {
+                    submit([state](){ state->run(); });
+                }
+
+                state->run();
+
+                std::unique_lock lock{state->mutex};
+                state->finished.wait(lock, [&state](){ return state->completed == state->count; });
+
+                if(state->error)
+                {
+                    std::rethrow_exception(state->error);
+                }
+            }
+
+        private:
+            struct ParallelForState
+            {
+                std::size_t count{0};
+                std::atomic<std::size_t> next{0};
+                std::size_t completed{0};
+                std::function<void(const std::size_t&)> function;
+                std::exception_ptr error;
+                std::mutex mutex;
+                std::condition_variable finished;
+
+                void run();
+            };
+
+            void workerLoop();
+
+        private:
+            std::vector<std::thread> workers;
+            std::queue<std::function<void()>> tasks;
+            std::mutex queueMutex;
+            std::condition_variable queueCondition;
+            bool stopping{false};
+    };
+} // namespace utils::threading
@@ -1,41 +1,172 @@
 #include "Logger.hpp"
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "BoundedQueue.hpp"
 
 namespace utils::logger
 {
-    void setup(const std::string_view& level)
+    namespace
     {
-        if(level.compare(utils::constants::error) != 0 &&
-           level.compare(utils::constants::critical) != 0&&
-           level.compare(utils::constants::warning) != 0&&
-           level.compare(utils::constants::debug) != 0&&
-           level.compare(utils::constants::info) != 0)
-        {
-            throw std::invalid_argument{"Invalid configuration parameter for logger provided!"};
-        }
+        constexpr std::array<std::pair<std::string_view, spdlog::level::level_enum>, 5> levelNames{{
+            {utils::constants::error, spdlog::level::err},
+            {utils::constants::critical, spdlog::level::critical},
+            {utils::constants::warning, spdlog::level::warn},
+            {utils::constants::debug, spdlog::level::debug},
+            {utils::constants::info, spdlog::level::info}
+        }};
 
-        if(level.compare(utils::constants::error) == 0)
-        {
-            spdlog::set_level(spdlog::level::err);
-        }
-        if(level.compare(utils::constants::critical) == 0)
-        {
-            spdlog::set_level(spdlog::level::critical);
-        }
-        if(level.compare(utils::constants::warning) == 0)
+        struct LogRecord
         {
-            spdlog::set_level(spdlog::level::warn);
-        }
-        if(level.compare(utils::constants::debug) == 0)
+            spdlog::level::level_enum level{spdlog::level::info};
+            spdlog::log_clock::time_point time;
+            std::string message;
+        };
+
+        // Owner of the queue and the thread writing it. The writer sleeps while the queue is empty, producers only
+        // touch the mutex to wake it up.
+        class AsyncSink
         {
-            spdlog::set_level(spdlog::level::debug);
-        }
-        if(level.compare(utils::constants::info) == 0)
+            public:
+                explicit AsyncSink(const std::size_t& queueCapacity) :
+                            queue{queueCapacity},
+                            writer{[this]() { run(); }}
+                {
+
+                }
+
+                // Pending messages are written before the thread ends
+                ~AsyncSink()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        stopping = true;
+                    }
+                    wakeUp.notify_one();
+                    writer.join();
+                }
+
+                void push(const spdlog::level::level_enum& level, const std::string_view& message)
+                {
+                    const auto pushed = queue.tryPush([&](LogRecord& record)
+                    {
+                        record.level = level;
+                        record.time = spdlog::log_clock::now();
+                        // Assigning keeps the capacity of the slot, so steady logging does not allocate
+                        record.message.assign(message.data(), message.size());
+                    });
+
+                    if(!pushed)
+                    {
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+
+                    // Pairs with the writer announcing its sleep and then checking the count, one of the two sees the other
+                    pushedCount.fetch_add(1, std::memory_order_seq_cst);
+                    if(sleeping.load(std::memory_order_seq_cst))
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        wakeUp.notify_one();
+                    }
+                }
+
+                void flush()
+                {
+                    const auto target = pushedCount.load(std::memory_order_seq_cst);
+                    std::unique_lock<std::mutex> lock{mutex};
+                    written.wait(lock, [&]() { return writtenCount >= target; });
+                }
+
+                std::uint64_t droppedMessages() const
+                {
+                    return dropped.load(std::memory_order_relaxed);
+                }
+
+            private:
+                void run()
+                {
+                    std::uint64_t reportedDrops = 0;
+                    while(true)
+                    {
+                        std::uint64_t batch = 0;
+                        while(queue.tryPop([](LogRecord& record)
+                              {
+                                  spdlog::default_logger_raw()->log(record.time, spdlog::source_loc{}, record.level,
+                                                                    spdlog::string_view_t{record.message.data(), record.message.size()});
+                              }))
+                        {
+                            ++batch;
+                        }
+
+                        const auto drops = dropped.load(std::memory_order_relaxed);
+                        if(drops != reportedDrops)
+                        {
+                            spdlog::warn("{} log messages were dropped, the async queue was full", drops - reportedDrops);
+                            reportedDrops = drops;
+                        }
+
+                        std::unique_lock<std::mutex> lock{mutex};
+                        writtenCount += batch;
+                        written.notify_all();
+
+                        // A message may be popped before its producer counted it, so the written count can be ahead for a moment
+                        sleeping.store(true, std::memory_order_seq_cst);
+                        if(pushedCount.load(std::memory_order_seq_cst) <= writtenCount)
+                        {
+                            if(stopping)
+                            {
+                                break;
+                            }
+
+                            wakeUp.wait(lock, [&]() { return stopping || pushedCount.load(std::memory_order_seq_cst) > writtenCount; });
+                        }
+                        sleeping.store(false, std::memory_order_relaxed);
+                    }
+
+                    spdlog::default_logger_raw()->flush();
+                }
+
+            private:
+                threading::BoundedQueue<LogRecord> queue;
+                std::atomic<std::uint64_t> pushedCount{0};
+                std::atomic<std::uint64_t> dropped{0};
+                std::atomic<bool> sleeping{false};
+
+                // Guarded by mutex
+                std::uint64_t writtenCount{0};
+                bool stopping{false};
+                std::mutex mutex;
+                std::condition_variable wakeUp;
+                std::condition_variable written;
+
+                std::thread writer;
+        };
+
+        std::atomic<AsyncSink*> asyncSink{nullptr};
+        std::once_flag exitHandlerRegistered;
+    } // namespace
+
+    void setup(const std::string_view& level)
+    {
+        for(const auto& [name, spdlogLevel] : levelNames)
         {
-            spdlog::set_level(spdlog::level::info);
+            if(level == name)
+            {
+                spdlog::set_level(spdlogLevel);
+                return;
+            }
         }
 
+        throw std::invalid_argument{"Invalid configuration parameter for logger provided!"};
     }
 
     void setup(const utils::constants::LogLevels& level)
@@ -48,14 +179,13 @@ namespace utils::logger
         case utils::constants::LogLevels::critical :
             spdlog::set_level(spdlog::level::critical);
             break;
-            case utils::constants::LogLevels::warning :
+        case utils::constants::LogLevels::warning :
             spdlog::set_level(spdlog::level::warn);
             break;
-
-            case utils::constants::LogLevels::debug :
+        case utils::constants::LogLevels::debug :
             spdlog::set_level(spdlog::level::debug);
             break;
-            case utils::constants::LogLevels::info :
+        case utils::constants::LogLevels::info :
             spdlog::set_level(spdlog::level::info);
             break;
         default:
@@ -63,4 +193,55 @@ namespace utils::logger
             break;
         }
     }
+
+    void startAsync(const std::size_t& queueCapacity)
+    {
+        if(asyncSink.load(std::memory_order_acquire) != nullptr)
+        {
+            return;
+        }
+
+        // The spdlog registry is created first, so the exit handler runs before the registry is destroyed
+        spdlog::default_logger_raw();
+        std::call_once(exitHandlerRegistered, []() { std::atexit(stopAsync); });
+
+        asyncSink.store(new AsyncSink{queueCapacity}, std::memory_order_release);
+    }
+
+    void stopAsync()
+    {
+        delete asyncSink.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    void flush()
+    {
+        if(auto sink = asyncSink.load(std::memory_order_acquire))
+        {
+            sink->flush();
+        }
+
+        spdlog::default_logger_raw()->flush();
+    }
+
+    std::uint64_t droppedMessages()
+    {
+        const auto sink = asyncSink.load(std::memory_order_acquire);
+        return sink != nullptr ? sink->droppedMessages() : 0;
+    }
+
+    namespace detail
+    {
+        bool isAsync()
+        {
+            return asyncSink.load(std::memory_order_relaxed) != nullptr;
+        }
+
+        void enqueue(const spdlog::level::level_enum& level, const std::string_view& message)
+        {
+            if(auto sink = asyncSink.load(std::memory_order_acquire))
+            {
+                sink->push(level, message);
+            }
+        }
+    } // namespace detail
 } // namespace imageload::utils::logger
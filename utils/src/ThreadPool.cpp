@@ -0,0 +1,103 @@
+#include "ThreadPool.hpp"
+
+namespace utils::threading
+{
+    ThreadPool::ThreadPool(const unsigned int& workerCount)
+    {
+        auto threadCount = workerCount != 0 ? workerCount : std::thread::hardware_concurrency();
+        if(threadCount == 0)
+        {
+            threadCount = 1;
+        }
+
+        workers.reserve(threadCount);
+        for(unsigned int iter = 0; iter < threadCount; ++iter)
+        {
+            workers.emplace_back([this](){ workerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock{queueMutex};
+            stopping = true;
+        }
+        queueCondition.notify_all();
+
+        for(auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    unsigned int ThreadPool::workerCount() const
+    {
+        return static_cast<unsigned int>(workers.size());
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard lock{queueMutex};
+            tasks.push(std::move(task));
+        }
+        queueCondition.notify_one();
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        while(true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock{queueMutex};
+                queueCondition.wait(lock, [this](){ return stopping || !tasks.empty(); });
+
+                //Drain the queue before stopping, submitted work is never dropped
+                if(tasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+
+            task();
+        }
+    }
+
+    void ThreadPool::ParallelForState::run()
+    {
+        std::size_t processed = 0;
+        for(auto index = next.fetch_add(1); index < count; index = next.fetch_add(1))
+        {
+            try
+            {
+                function(index);
+            }
+            catch(...)
+            {
+                std::lock_guard lock{mutex};
+                if(!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+            ++processed;
+        }
+
+        if(processed == 0)
+        {
+            return;
+        }
+
+        std::lock_guard lock{mutex};
+        completed += processed;
+        if(completed == count)
+        {
+            finished.notify_all();
+        }
+    }
+} // namespace utils::threading